@@ -0,0 +1,83 @@
+#!/bin/sh
+#FECS: Fast Electronic Circuits Simulator
+#Copyright (C) 2017 Filip Kocina
+#
+#This program is free software: you can redistribute it and/or modify
+#it under the terms of the GNU General Public License as published by
+#the Free Software Foundation, either version 3 of the License, or
+#(at your option) any later version.
+#
+#This program is distributed in the hope that it will be useful,
+#but WITHOUT ANY WARRANTY; without even the implied warranty of
+#MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#GNU General Public License for more details.
+#
+#You should have received a copy of the GNU General Public License
+#along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#runs a circuit at reference settings and then across DTS x EPSS x TESTS;
+#all outputs are sampled on the same grid and compared with the reference;
+#the last column marks settings on the Pareto front of time and errors (ONE
+#is the logic threshold of the circuit, U/2 unless the netlist sets one):
+#  NETLIST=my.fecs sh bench/accuracy.sh ./fecs bench/gen bench/compare
+#  CIRCUIT=multiplier:8 DTS="1e-10 4e-10" sh bench/accuracy.sh
+FECS=${1:-./fecs}
+GEN=${2:-bench/gen}
+COMPARE=${3:-bench/compare}
+CIRCUIT=${CIRCUIT:-"adder:16"}
+ACTIVITY=${ACTIVITY:-"1"}
+TMAX=${TMAX:-"4e-7"}
+GRID=${GRID:-"1e-9"}
+ONE=${ONE:-"1.65"}
+REF_DT=${REF_DT:-"1e-11"}
+REF_EPS=${REF_EPS:-"1e-30"}
+DTS=${DTS:-"5e-11 1e-10 2e-10 4e-10"}
+EPSS=${EPSS:-"1e-20 1e-12 1e-8"}
+TESTS=${TESTS:-"3 1"}
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+if [ -n "$NETLIST" ]; then cp "$NETLIST" "$DIR/net.fecs"
+else
+  "$GEN" "${CIRCUIT%:*}" "${CIRCUIT#*:}" "$ACTIVITY" > "$DIR/net.fecs" || exit 1
+fi
+
+run() { #dt eps test output; prints the execution time
+  opts="tmax = $TMAX grid = $GRID dt = $1 eps = $2 test = $3"
+  if head -n 1 "$DIR/net.fecs" | grep -q '^setup {.*}'; then #one-line setup
+    sed "1s/}/ $opts }/" "$DIR/net.fecs"
+  else
+    echo "setup { $opts }"
+    cat "$DIR/net.fecs"
+  fi | "$FECS" > "$4" 2> "$DIR/err" || { cat "$DIR/err" >&2; exit 1; }
+  awk -F': ' '/^Execution time/ {print $2 + 0}' "$DIR/err"
+}
+
+run "$REF_DT" "$REF_EPS" 3 "$DIR/ref.tsv" > /dev/null || exit 1
+for dt in $DTS; do
+  for eps in $EPSS; do
+    for test in $TESTS; do
+      sec=$(run "$dt" "$eps" "$test" "$DIR/out.tsv") || exit 1
+      printf '%s\t%s\t%s\t%s\t%s\n' "$dt" "$eps" "$test" "$sec" \
+        "$("$COMPARE" "$DIR/ref.tsv" "$DIR/out.tsv" "$ONE")"
+    done
+  done
+done > "$DIR/table"
+printf 'dt\teps\ttest\tseconds\tmax_error\tcrossing_error\tmissed'
+printf '\tmismatches\tpareto\n'
+awk -F'\t' '{for(i = 1; i <= 8; ++i) v[NR, i] = $i; line[NR] = $0}
+  END { #not dominated in seconds, voltage, crossing and logic errors
+    for(r = 1; r <= NR; ++r) {
+      front = "yes"
+      for(s = 1; s <= NR; ++s) {
+        if(s == r) continue
+        le = 1; lt = 0
+        for(i = 4; i <= 8; ++i) {
+          if(v[s, i] > v[r, i]) le = 0
+          if(v[s, i] < v[r, i]) lt = 1
+        }
+        if(le && lt) front = "no"
+      }
+      print line[r] "\t" front
+    }
+  }' "$DIR/table"
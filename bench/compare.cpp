@@ -0,0 +1,106 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//compares an output with a reference output on the same time grid (see the
+//setup option grid) at the logic threshold, e.g. compare ref.tsv out.tsv 1.65;
+//prints the maximal voltage error, the maximal error of threshold-crossing
+//times, the number of crossings missing in either output and the samples of
+//different logic values:
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+typedef long double Number;
+
+struct Table {
+  vector<string> names;
+  vector<Number> times;
+  vector<vector<Number> > columns;
+  bool load(const char *file) {
+    ifstream in(file);
+    string line, name;
+    if(!getline(in, line)) return false;
+    stringstream header(line);
+    header >> name; //t
+    while(header >> name) names.push_back(name);
+    columns.resize(names.size());
+    while(getline(in, line)) {
+      stringstream ss(line);
+      Number t, val;
+      if(!(ss >> t)) continue;
+      times.push_back(t);
+      for(size_t i = 0; i < names.size(); ++i)
+        columns[i].push_back(ss >> val? val: NAN);
+    }
+    return true;
+  }
+  vector<Number> crossings(size_t col, Number one) const { //interpolated
+    vector<Number> res;
+    const vector<Number> &v = columns[col];
+    for(size_t i = 1; i < v.size(); ++i)
+      if((v[i-1] < one) != (v[i] < one))
+        res.push_back(times[i-1]+(times[i]-times[i-1])*(one-v[i-1])/
+                      (v[i]-v[i-1]));
+    return res;
+  }
+};
+
+int main(int argc, char **argv) {
+  if(argc < 4) {
+    cerr << "Usage: " << argv[0] << " reference output one" << endl;
+    return 1;
+  }
+  Table ref, out;
+  if(!ref.load(argv[1]) || !out.load(argv[2])) {
+    cerr << "Cannot read the outputs." << endl;
+    return 1;
+  }
+  if(ref.names != out.names) {
+    cerr << "The outputs have different nets." << endl;
+    return 1;
+  }
+  Number one = strtold(argv[3], NULL), maxErr = 0, crossErr = 0;
+  size_t rows = min(ref.times.size(), out.times.size()), missed = 0,
+    mismatches = 0;
+  for(size_t i = 0; i < rows; ++i)
+    if(ref.times[i] != out.times[i]) {
+      cerr << "The outputs have different times." << endl;
+      return 1;
+    }
+  for(size_t c = 0; c < ref.names.size(); ++c) {
+    for(size_t i = 0; i < rows; ++i) {
+      Number a = ref.columns[c][i], b = out.columns[c][i];
+      maxErr = max(maxErr, fabsl(a-b));
+      if((a < one) != (b < one)) ++mismatches;
+    }
+    vector<Number> a = ref.crossings(c, one), b = out.crossings(c, one);
+    size_t n = min(a.size(), b.size());
+    for(size_t i = 0; i < n; ++i) crossErr = max(crossErr, fabsl(a[i]-b[i]));
+    missed += max(a.size(), b.size())-n;
+  }
+  cout << maxErr << "\t" << crossErr << "\t" << missed << "\t" << mismatches
+       << endl;
+  return 0;
+}
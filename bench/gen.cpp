@@ -0,0 +1,187 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//generators of scalable netlists for benchmarks, e.g. gen adder 64 > a.fecs;
+//inputs are driven by generators so that the circuits switch until tmax:
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+const double PERIOD = 1e-7; //of input vectors at activity 1 (adders settle)
+
+string net(const string &name, size_t i) {
+  stringstream ss;
+  ss << name << i;
+  return ss.str();
+}
+
+void ring(size_t n) { //odd number of inverters with alternating init. values
+  if(n < 3) n = 3;
+  n |= 1;
+  for(size_t i = 0; i < n; ++i)
+    cout << net("x", i) << " = not(" << net("x", (i+n-1)%n) << " & "
+         << (i+1)%2 << ")" << endl;
+}
+
+void chain(size_t n) { //inverters driven by a clock
+  cout << "x0 = clock(" << PERIOD << ")" << endl;
+  for(size_t i = 1; i <= n; ++i)
+    cout << net("x", i) << " = not(" << net("x", i-1) << ")" << endl;
+}
+
+void inputs(size_t n, double activity) { //random operands a and b
+  cout << "a = random(" << n << ", " << PERIOD/activity << ", 1)" << endl;
+  cout << "b = random(" << n << ", " << PERIOD/activity << ", 2)" << endl;
+}
+
+//full adder of nets a, b and c into s and co (majority by NANDs):
+void full_adder(const string &a, const string &b, const string &c,
+                const string &s, const string &co) {
+  cout << s << " = xor(" << a << ", " << b << ", " << c << ")" << endl;
+  cout << co << " = nand(nand(" << a << ", " << b << "), nand(" << c
+       << ", xor(" << a << ", " << b << ")))" << endl;
+}
+
+void adder(size_t n, double activity) { //ripple carry
+  inputs(n, activity);
+  cout << "c0 = 0" << endl;
+  for(size_t i = 0; i < n; ++i)
+    full_adder(net("a", i), net("b", i), net("c", i), net("s", i),
+               net("c", i+1));
+}
+
+void cla(size_t n, double activity) { //carry-lookahead in blocks of 4 bits
+  inputs(n, activity);
+  cout << "c0 = 0" << endl;
+  for(size_t i = 0; i < n; ++i) {
+    cout << net("g", i) << " = not(nand(" << net("a", i) << ", "
+         << net("b", i) << "))" << endl;
+    cout << net("p", i) << " = xor(" << net("a", i) << ", " << net("b", i)
+         << ")" << endl;
+    cout << net("s", i) << " = xor(" << net("p", i) << ", " << net("c", i)
+         << ")" << endl;
+  }
+  for(size_t i = 0; i < n; ++i) { //c(i+1) = g(i) + p(i) g(i-1) + ...
+    size_t base = i/4*4;
+    cout << net("c", i+1) << " = not(aoi(" << net("g", i);
+    for(size_t j = i; j-- > base; ) { //p(i) ... p(j+1) g(j)
+      cout << ", (";
+      for(size_t k = i; k > j; --k) cout << net("p", k) << ", ";
+      cout << net("g", j) << ")";
+    }
+    cout << ", (";
+    for(size_t k = i+1; k-- > base; ) cout << net("p", k) << ", ";
+    cout << net("c", base) << ")))" << endl;
+  }
+}
+
+void multiplier(size_t n, double activity) { //array of carry-save adders
+  inputs(n, activity);
+  for(size_t i = 0; i < n; ++i)
+    for(size_t j = 0; j < n; ++j)
+      cout << "pp" << i << "_" << j << " = not(nand(" << net("a", i) << ", "
+           << net("b", j) << "))" << endl;
+  cout << "z = 0" << endl;
+  vector<string> sum(n+1, "z"); //partial sum shifted by the row
+  for(size_t j = 0; j < n; ++j) {
+    string carry = "z";
+    vector<string> next(n+1, "z");
+    for(size_t i = 0; i < n; ++i) {
+      stringstream pp, s, c;
+      pp << "pp" << i << "_" << j;
+      s << "s" << j << "_" << i;
+      c << "c" << j << "_" << i;
+      full_adder(sum[i+1 <= n? i+1: n], pp.str(), carry, s.str(), c.str());
+      next[i] = s.str();
+      carry = c.str();
+    }
+    next[n] = carry;
+    cout << net("m", j) << " = " << next[0] << endl;
+    sum = next;
+  }
+  for(size_t i = 1; i <= n; ++i)
+    cout << net("m", n+i-1) << " = " << sum[i] << endl;
+}
+
+void parity(size_t n, double activity) { //tree of 2-input XORs
+  cout << "a = random(" << n << ", " << PERIOD/activity << ", 1)" << endl;
+  vector<string> level;
+  for(size_t i = 0; i < n; ++i) level.push_back(net("a", i));
+  size_t k = 0;
+  while(level.size() > 1) {
+    vector<string> next;
+    for(size_t i = 0; i+1 < level.size(); i += 2) {
+      string x = net("x", k++);
+      cout << x << " = xor(" << level[i] << ", " << level[i+1] << ")" << endl;
+      next.push_back(x);
+    }
+    if(level.size()%2) next.push_back(level.back());
+    level = next;
+  }
+  cout << "y = " << level[0] << endl;
+}
+
+void logic(size_t n, double activity, unsigned seed) { //random gates
+  const char *types[] = {"nand", "nor", "xor", "not"};
+  size_t width = n < 64? n: 64;
+  cout << "a = random(" << width << ", " << PERIOD/activity << ", " << seed
+       << ")" << endl;
+  srand(seed);
+  vector<string> nets;
+  for(size_t i = 0; i < width; ++i) nets.push_back(net("a", i));
+  for(size_t i = 0; i < n; ++i) {
+    size_t type = rand()%4, inputs = type == 3? 1: 2+rand()%2;
+    cout << net("x", i) << " = " << types[type] << "(";
+    for(size_t j = 0; j < inputs; ++j) { //mostly recent nets (depth)
+      size_t size = nets.size(), window = size < 32? size: 32;
+      cout << (j? ", ": "") << nets[size-1-rand()%window];
+    }
+    cout << ")" << endl;
+    nets.push_back(net("x", i));
+  }
+}
+
+int main(int argc, char **argv) {
+  if(argc < 3) {
+    cerr << "Usage: " << argv[0] << " ring|chain|adder|cla|multiplier|parity"
+            "|logic size [activity = 1] [seed = 1]" << endl;
+    return 1;
+  }
+  string kind = argv[1];
+  size_t n = strtoul(argv[2], NULL, 10);
+  double activity = argc > 3? strtod(argv[3], NULL): 1;
+  unsigned seed = argc > 4? strtoul(argv[4], NULL, 10): 1;
+  if(activity <= 0) activity = 1;
+  if(kind == "ring") ring(n);
+  else if(kind == "chain") chain(n);
+  else if(kind == "adder") adder(n, activity);
+  else if(kind == "cla") cla(n, activity);
+  else if(kind == "multiplier") multiplier(n, activity);
+  else if(kind == "parity") parity(n, activity);
+  else if(kind == "logic") logic(n, activity, seed);
+  else {
+    cerr << "Unknown circuit \"" << kind << "\"." << endl;
+    return 1;
+  }
+  return 0;
+}
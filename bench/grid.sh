@@ -0,0 +1,65 @@
+#!/bin/sh
+#FECS: Fast Electronic Circuits Simulator
+#Copyright (C) 2017 Filip Kocina
+#
+#This program is free software: you can redistribute it and/or modify
+#it under the terms of the GNU General Public License as published by
+#the Free Software Foundation, either version 3 of the License, or
+#(at your option) any later version.
+#
+#This program is distributed in the hope that it will be useful,
+#but WITHOUT ANY WARRANTY; without even the implied warranty of
+#MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#GNU General Public License for more details.
+#
+#You should have received a copy of the GNU General Public License
+#along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#checks dense output: rows of the output grid at step boundaries have to
+#equal the rows of the steps for every solver of the gates; prints the
+#failing settings and exits with 1 if any:
+#  CIRCUITS="adder:8" sh bench/grid.sh ./fecs bench/gen
+FECS=${1:-./fecs}
+GEN=${2:-bench/gen}
+CIRCUITS=${CIRCUITS:-"ring:11 adder:8 multiplier:4"}
+OPTS=${OPTS:-"fused=on fused=off predict=on dedup=on codegen"}
+DT=${DT:-"1e-10"}
+GRID=${GRID:-"1e-9"}
+TMAX=${TMAX:-"1e-7"}
+TOL=${TOL:-"1e-6"} #volts
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+run() { #setup options, output
+  { echo "setup { tmax = $TMAX dt = $DT $1 }"; cat "$DIR/net.fecs"; } |
+    "$FECS" > "$2" 2> "$DIR/err" || { cat "$DIR/err" >&2; exit 1; }
+}
+
+failed=0
+for circuit in $CIRCUITS; do
+  "$GEN" "${circuit%:*}" "${circuit#*:}" 1 > "$DIR/net.fecs" || exit 1
+  for opt in $OPTS; do
+    case $opt in
+      codegen) set="codegen = \"$DIR/kernels\"" ;;
+      *) set="${opt%=*} = ${opt#*=}" ;;
+    esac
+    run "$set" "$DIR/steps.tsv"
+    run "$set grid = $GRID" "$DIR/grid.tsv"
+    awk -v tol="$TOL" -F'\t' 'FNR == 1 {next} #the header
+      NR == FNR {row[$1] = $0; next}
+      { #a grid row at a step boundary
+        if(!($1 in row)) next
+        n = split(row[$1], v, "\t")
+        for(i = 2; i <= n; ++i) {
+          d = $i-v[i]
+          if(d > tol || -d > tol) {bad = 1; print "t = " $1 ": " $i " != " v[i]}
+        }
+      }
+      END {exit bad}' "$DIR/steps.tsv" "$DIR/grid.tsv" > "$DIR/diff" || {
+      printf '%s %s: ' "$circuit" "$opt"
+      head -n 1 "$DIR/diff"
+      failed=1
+    }
+  done
+done
+exit $failed
@@ -0,0 +1,64 @@
+#!/bin/sh
+#FECS: Fast Electronic Circuits Simulator
+#Copyright (C) 2017 Filip Kocina
+#
+#This program is free software: you can redistribute it and/or modify
+#it under the terms of the GNU General Public License as published by
+#the Free Software Foundation, either version 3 of the License, or
+#(at your option) any later version.
+#
+#This program is distributed in the hope that it will be useful,
+#but WITHOUT ANY WARRANTY; without even the implied warranty of
+#MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#GNU General Public License for more details.
+#
+#You should have received a copy of the GNU General Public License
+#along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#runs the generated circuits across the settings and prints a TSV table;
+#the first thread count of THREADS is the reference of the efficiency:
+#  CIRCUITS="adder:64 logic:5000" THREADS="0 4" sh bench/run.sh ./fecs bench/gen
+FECS=${1:-./fecs}
+GEN=${2:-bench/gen}
+CIRCUITS=${CIRCUITS:-"ring:101 chain:1000 adder:64 cla:64 multiplier:16 parity:1024 logic:5000"}
+THREADS=${THREADS:-"0 2 4"}
+BUNCHES=${BUNCHES:-"0"}
+DTS=${DTS:-"1e-10"}
+EPSS=${EPSS:-"1e-20"}
+TMAX=${TMAX:-"2e-7"}
+ACTIVITY=${ACTIVITY:-"1"}
+NET=$(mktemp) ERR=$(mktemp)
+trap 'rm -f "$NET" "$ERR"' EXIT
+
+printf 'circuit\tsize\tthreads\tbunch\tdt\teps\tseconds\tsteps\tequations'
+printf '\tsteps_per_s\teq_steps_per_s\tefficiency\n'
+for circuit in $CIRCUITS; do
+  kind=${circuit%:*} size=${circuit#*:}
+  "$GEN" "$kind" "$size" "$ACTIVITY" > "$NET" || exit 1
+  for dt in $DTS; do
+    for eps in $EPSS; do
+      for bunch in $BUNCHES; do
+        ref=
+        for threads in $THREADS; do
+          { echo "setup { tmax = $TMAX dt = $dt eps = $eps bunch = $bunch" \
+                 "threads = $threads output = off }"; cat "$NET"; } |
+            "$FECS" 2> "$ERR" > /dev/null || { cat "$ERR" >&2; exit 1; }
+          awk -v c="$kind" -v s="$size" -v b="$bunch" -v dt="$dt" \
+              -v eps="$eps" -v tmax="$TMAX" -v ref="$ref" -F': ' '
+            /^Number of threads/ {n = $2}
+            /^Algebraic equations/ || /^Differential equations/ {eqs += $2}
+            /^Execution time/ {sec = $2 + 0}
+            END {
+              steps = int(tmax/dt+0.5)+1
+              if(ref == "") ref = sec*n
+              printf "%s\t%s\t%d\t%s\t%s\t%s\t%g\t%d\t%d\t%g\t%g\t%.3f\n", c, s,
+                n, b, dt, eps, sec, steps, eqs, steps/sec, eqs*steps/sec,
+                ref/(sec*n)
+            }' "$ERR"
+          [ -n "$ref" ] || ref=$(awk -F': ' '/^Number of threads/ {n = $2}
+            /^Execution time/ {sec = $2 + 0} END {print sec*n}' "$ERR")
+        done
+      done
+    done
+  done
+done
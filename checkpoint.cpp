@@ -0,0 +1,79 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "checkpoint.h"
+#include <cstring>
+using namespace std;
+
+string Checkpoint::file, Checkpoint::from;
+size_t Checkpoint::every = 0;
+volatile sig_atomic_t Checkpoint::bRequested = 0;
+
+static const char MAGIC[] = "FECS\4";
+
+void Checkpoint::write(const string &file) { //replaces the old one atomically
+  string tmp = file+".tmp";
+  FILE *out = fopen(tmp.c_str(), "wb");
+  if(!out) error_exit("Cannot write checkpoint \""+tmp+"\".");
+  fwrite(MAGIC, sizeof(MAGIC), 1, out);
+  put(out, t);
+  put(out, tInputs); //the step of t has not seen its inputs yet
+  put(out, tBegin); //of the output grid
+  put(out, curMult);
+  put(out, curStep);
+  put(out, MAXORD);
+  put(out, nSkipped);
+  put(out, groups.size());
+  deque<Group*>::const_iterator it, end = groups.end();
+  for(it = groups.begin(); it != end; ++it) (*it)->save(out);
+  if(fclose(out) || rename(tmp.c_str(), file.c_str()))
+    error_exit("Cannot write checkpoint \""+file+"\".");
+}
+
+bool Checkpoint::init(void (*replay)()) { //true if the state was restored
+  if(file != "") signal(SIGUSR1, request);
+  if(from == "") return false;
+  FILE *in = fopen(from.c_str(), "rb");
+  if(!in) error_exit("Cannot open checkpoint \""+from+"\".");
+  setvbuf(in, NULL, _IOFBF, DEFAULT_STIMULUS_BUF);
+  char magic[sizeof(MAGIC)];
+  size_t size;
+  if(fread(magic, sizeof(magic), 1, in) != 1 ||
+     memcmp(magic, MAGIC, sizeof(MAGIC)))
+    error_exit("\""+from+"\" is not a checkpoint.");
+  get(in, t);
+  get(in, tInputs);
+  get(in, tBegin);
+  get(in, curMult);
+  get(in, curStep);
+  get(in, MAXORD);
+  get(in, nSkipped);
+  Number tRestored = t;
+  t = tInputs;
+  replay(); //its events would wake the loaded gates
+  t = tRestored;
+  get(in, size);
+  if(size != groups.size())
+    error_exit("Checkpoint does not match the circuit.");
+  deque<Group*>::const_iterator it, end = groups.end();
+  for(it = groups.begin(); it != end; ++it) (*it)->load(in);
+  fclose(in);
+  return true;
+}
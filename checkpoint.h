@@ -0,0 +1,57 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __CHECKPOINT_H__
+#define __CHECKPOINT_H__
+
+#include "main.h"
+#include <csignal>
+
+//binary snapshot of the solver state between two steps, written every given
+//number of steps or on SIGUSR1 and restored after the initial conditions;
+//inputs are replayed up to the restored time before the state is loaded, so
+//resting gates stay at rest (the circuit and its partition into groups must
+//be the same); variant k of a sweep uses file.k and faulty
+//copies write none:
+class Checkpoint {
+  static std::string file, from;
+  static size_t every;
+  static volatile sig_atomic_t bRequested;
+  static void request(int) {bRequested = 1;}
+  static void save() {
+    bRequested = 0;
+    if(file != "") write(file);
+  }
+public:
+  static bool init(void (*)()); //replays the inputs
+  static void set_every(size_t n) {every = n;}
+  static void set_file(const std::string &name) {file = name;}
+  static void set_restore(const std::string &name) {from = name;}
+  static void suffix(const std::string &str) { //one snapshot per variant
+    if(file != "") file += str;
+    if(from != "") from += str;
+  }
+  static void step() { //after the step
+    if(bRequested || (every && !(curStep%every))) save();
+  }
+  static void write(const std::string &);
+};
+
+#endif
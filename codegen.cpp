@@ -0,0 +1,222 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "codegen.h"
+#include <dlfcn.h>
+#include <sys/stat.h>
+using namespace std;
+
+string Codegen::dir;
+size_t Codegen::nKernels = 0, Codegen::nSolved = 0, Codegen::nGates = 0;
+
+static string literal(ConstNumber num) { //exact (hexadecimal) long double
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%LaL", num);
+  return buf;
+}
+
+static unsigned long long fnv1a(const string &str) {
+  unsigned long long h = 14695981039346656037ULL;
+  string::const_iterator it, end = str.end();
+  for(it = str.begin(); it != end; ++it)
+    h = (h^(unsigned char)*it)*1099511628211ULL;
+  return h;
+}
+
+//locals of the numbers of a gate (stored after the step) and of its inputs:
+class Wires {
+  std::map<const Number*,string> names;
+  std::vector<Number*> &wires;
+  ostringstream loads, stores;
+public:
+  Wires(std::vector<Number*> &wires): wires(wires) {}
+  const string &local(Number *num, const string &name) { //state of the gate
+    string &res = names[num];
+    if(res == "") { //can be shared by more capacitors
+      res = name;
+      loads << "  Number " << name << " = *p[" << wires.size() << "];\n";
+      stores << "  *p[" << wires.size() << "] = " << name << ";\n";
+      wires.push_back(num);
+    }
+    return res;
+  }
+  const string &operator[](const Number *num) {
+    string &name = names[num];
+    if(name == "") {
+      stringstream ss;
+      ss << "x" << wires.size();
+      name = ss.str();
+      loads << "  const Number " << name << " = *p[" << wires.size() << "];\n";
+      wires.push_back(const_cast<Number*>(num));
+    }
+    return name;
+  }
+  string sum(const std::vector<const Number*> &nums) { //as ::sum
+    string res;
+    std::vector<const Number*>::const_iterator it, end = nums.end();
+    for(it = nums.begin(); it != end; ++it)
+      res += (it == nums.begin()? "": "+")+(*this)[*it];
+    return res;
+  }
+  string network(const Network *net) { //as Network::eval
+    std::vector<string> stack;
+    std::vector<Network::Node>::const_iterator it, end = net->nodes.end();
+    for(it = net->nodes.begin(); it != end; ++it)
+      if(it->op == Network::LEAF) stack.push_back((*this)[it->G()]);
+      else {
+        bool bPar = it->op == Network::PAR;
+        string res = bPar? stack.back(): "1/"+stack.back();
+        stack.pop_back();
+        for(size_t n = it->n; --n; stack.pop_back())
+          res += bPar? "+"+stack.back(): "+1/"+stack.back();
+        stack.push_back(bPar? "("+res+")": "1/("+res+")");
+      }
+    return stack.front();
+  }
+  string load() const {return loads.str();}
+  string store() const {return stores.str();}
+};
+
+//solver of a gate after its name; equal gates get equal code on their wires:
+string Codegen::emit(Gate *gate) {
+  std::vector<Dae*> &daes = gate->daes;
+  size_t size = daes.size();
+  Wires wires(gate->wires);
+  std::vector<string> G(size);
+  for(size_t j = 0; j < size; ++j) { //the state of the gate in locals
+    Dae *dae = daes[j];
+    string s = num2str(j);
+    wires.local(&dae->res, "r"+s);
+    if(!dae->bODE) continue;
+    wires.local(&dae->cur_val, "c"+s);
+    wires.local(&dae->start, "s"+s);
+    wires.local(&dae->slope, "d"+s);
+    if(!dae->args.empty() || dae->net) G[j] = wires.local(dae->G, "G"+s);
+  }
+  for(size_t j = 0; j < size; ++j) //e.g. Gn of an input (not stored)
+    if(daes[j]->bODE && G[j] == "") G[j] = wires[daes[j]->G];
+  ostringstream first, body[2]; //the first term and the terms of orders 1, n
+  for(size_t j = 0; j < size; ++j) {
+    Dae *dae = daes[j];
+    string s = num2str(j);
+    if(!dae->bODE) continue;
+    first << "  c" << s << " = s" << s << " = r" << s << ";\n";
+    if(!dae->args.empty())
+      first << "  " << G[j] << " = " << wires.sum(dae->args) << ";\n";
+    else if(dae->net)
+      first << "  " << G[j] << " = " << wires.network(dae->net) << ";\n";
+  }
+  for(size_t o = 0; o < 2; ++o)
+    for(size_t j = 0; j < size; ++j) {
+      Dae *dae = daes[j];
+      string s = num2str(j);
+      ostream &os = body[o];
+      if(dae->bODE) {
+        os << "    c" << s << " *= " << G[j] << ";\n";
+        os << "    c" << s << " += " << wires[dae->i_val] << ";\n";
+        os << "    c" << s << " *= " << literal(coeff[dae->idx]) << "/ORD;\n";
+        if(!o) os << "    d" << s << " = c" << s << ";\n";
+        os << "    r" << s << " += c" << s << ";\n";
+        if(!o) os << "    if(fabsl(c" << s << ") > SETTLE) set = false;\n";
+        os << "    if(fabsl(c" << s << ") > EPS) bCont = true, n = 0;\n";
+      }
+      else {
+        os << "    r" << s << " = " << wires.sum(dae->args) << ";\n";
+        if(!o) os << "    r" << s << " += " << literal(U) << ";\n";
+        os << "    r" << s << " *= " << (dae->G == &Gi? literal(Gi):
+                                        wires[dae->G]) << ";\n";
+        if(bPower) os << "    Q += r" << s << "/ORD;\n";
+      }
+    }
+  ostringstream out;
+  out << "(Number *const *p, bool *settled, Number *q) {\n" << wires.load()
+      << first.str()
+      << "  bool bCont = false, set = true;\n  size_t n = 0, ORD = 1;\n"
+      << "  Number Q = 0;\n  {\n" << body[0].str()
+      << "  }\n  if(!bCont && ++n < TEST) bCont = true;\n"
+      << "  for(ORD = 2; bCont; ++ORD) {\n    bCont = false;\n" << body[1].str()
+      << "    if(!bCont && ++n < TEST) bCont = true;\n  }\n";
+  out << wires.store();
+  if(bPower) out << "  *q += Q*" << literal(dt) << ";\n";
+  out << "  *settled = set;\n  return ORD-1;\n}\n\n";
+  return out.str();
+}
+
+void Codegen::init() {
+  if(dir == "") return;
+  ostringstream src;
+  src << "#include <cmath>\n#include <cstddef>\n\ntypedef long double Number;\n"
+      << "static const Number EPS = " << literal(EPS) << ", SETTLE = "
+      << literal(STILL) << ";\nstatic const size_t TEST = " << TEST
+      << ";\n\n";
+  std::vector<Gate*> gates; //the gates of the kernels
+  std::vector<size_t> symbols; //their kernels
+  map<string,size_t> kernels; //one for each distinct code
+  deque<Group*>::const_iterator it, end = groups.end();
+  for(it = groups.begin(); it != end; ++it) {
+    std::vector<Gate*>::const_iterator gate, gend = (*it)->gates.end();
+    for(gate = (*it)->gates.begin(); gate != gend; ++gate, ++nGates) {
+      std::vector<Dae*>::const_iterator dae, dend = (*gate)->daes.end();
+      for(dae = (*gate)->daes.begin(); dae != dend && !(*dae)->poly; ++dae);
+      if(dae != dend) continue; //dense output records the terms
+      string code = emit(*gate);
+      map<string,size_t>::const_iterator k = kernels.find(code);
+      if(k == kernels.end()) {
+        k = kernels.insert(make_pair(code, kernels.size())).first;
+        src << "extern \"C\" size_t g" << k->second << code;
+      }
+      symbols.push_back(k->second);
+      gates.push_back(*gate);
+    }
+  }
+  const char *cxx = getenv("CXX");
+  string cmd = string(cxx? cxx: "c++")+" "+DEFAULT_CODEGEN_FLAGS;
+  stringstream ss;
+  ss << dir << "/" << hex << fnv1a(cmd+"\n"+src.str());
+  string base = ss.str(), lib = base+".so";
+  void *handle = dlopen(lib.c_str(), RTLD_NOW|RTLD_LOCAL);
+  if(!handle) { //compile and publish atomically (variants may race)
+    mkdir(dir.c_str(), 0777);
+    ss << "." << getpid();
+    string tmp = ss.str(), file = tmp+".cpp";
+    ofstream out(file.c_str());
+    if(!(out << src.str()) || (out.close(), !out))
+      error_exit("Cannot write kernels \""+file+"\".");
+    cmd += " -o "+tmp+".so "+file;
+    if(system(cmd.c_str()) || rename((tmp+".so").c_str(), lib.c_str()))
+      error_exit("Cannot compile kernels \""+file+"\".");
+    remove(file.c_str());
+    if(!(handle = dlopen(lib.c_str(), RTLD_NOW|RTLD_LOCAL)))
+      error_exit("Cannot load kernels \""+lib+"\".");
+  }
+  std::vector<Kernel> loaded(kernels.size());
+  for(size_t i = 0; i < loaded.size(); ++i)
+    if(!(loaded[i] = (Kernel)dlsym(handle, ("g"+num2str(i)).c_str())))
+      error_exit("Kernels \""+lib+"\" do not match the circuit.");
+  for(size_t i = 0; i < gates.size(); ++i)
+    gates[i]->kernel = loaded[symbols[i]];
+  nKernels = kernels.size();
+  nSolved = gates.size();
+}
+
+void Codegen::report() {
+  if(dir != "") cerr << "Generated kernels: " << nKernels << " for " << nSolved
+                     << " of " << nGates << " gates" << endl;
+}
@@ -0,0 +1,41 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __CODEGEN_H__
+#define __CODEGEN_H__
+
+#include "main.h"
+
+//straight-line C++ of the Taylor step of each gate: the numbers of a gate
+//are loaded from its wires (array offsets) into locals, the coefficients and
+//parameters are folded into constants; gates of equal structure share one
+//kernel, which are compiled by the system compiler into a shared object
+//cached by the hash of its source:
+class Codegen {
+  static std::string dir; //cache of the shared objects
+  static size_t nKernels, nSolved, nGates;
+  static std::string emit(Gate *);
+public:
+  static void init(); //after the polynomials for dense output are requested
+  static void report();
+  static void set_dir(const std::string &name) {dir = name;}
+};
+
+#endif
@@ -25,59 +25,96 @@
 
 inline bool logic_cast(ConstNumber num) {return num>=ONE;}
 
-class Condition {
+class Condition: public Tagged<Memory::CONDITIONS> {
 protected:
   bool val; //logic value
-  Number *Gn, *Gp; //conductivities changed according to val
+  Arg *arg; //its conductivities are changed according to val
 public:
-  Condition(Arg *a): val(false), Gn(&a->Gn), Gp(&a->Gp) {}
-  Condition(bool val = false, Number *Gn = NULL, Number *Gp = NULL):
-    val(val), Gn(Gn), Gp(Gp) {}
-  void eval() const {
+  Condition(bool val = false, Arg *arg = NULL): val(val), arg(arg) {}
+  void apply() const { //the conductivities of val
     if(val) {
-      *Gn = Gopen;
-      *Gp = Gclosed;
+      arg->Gn = Gopen;
+      arg->Gp = Gclosed;
     }
     else {
-      *Gp = Gopen;
-      *Gn = Gclosed;
+      arg->Gp = Gopen;
+      arg->Gn = Gclosed;
     }
+    arg->force();
+  }
+  void eval() const {
+    apply();
+    arg->wake(); //gates driven by arg change their slopes
   }
 };
 
-class ConditionCh: protected Condition { //conditions based on the value of res
+//conditions based on the value of res; instead of testing all of them in
+//each step, each one is tested in the first step in which it can cross ONE
+//(see Group::check) and the crossing is located within the step:
+class ConditionCh: protected Condition {
 protected:
   const Number *res;
+  std::vector<Dae*> traces; //capacitors summed into res
+  Group *group; //its timing wheel schedules the checks
+  size_t due; //the step of the next check
+  Number tCross; //time of the last crossing of ONE located within the step
+  void cross();
 public:
-  ConditionCh(Number *res = NULL): res(res) {}
-  ConditionCh(Number *res, Arg *a): res(res), Condition(a) {a->N = res; add();}
-  ConditionCh(Number *res, bool val, Number *Gn, Number *Gp):
-    res(res), Condition(val, Gn, Gp) {add();}
-  void add() {cur_conditions->push_back(this);}
+  using Condition::operator new; //counted although the base is protected
+  using Condition::operator delete;
+  ConditionCh(Number *res = NULL): res(res), due(-1), tCross(NAN) {}
+  ConditionCh(Number *res, Arg *a): res(res), Condition(false, a), due(-1),
+    tCross(NAN) {a->N = res; add();}
+  void add() {
+    cur_conditions->push_back(this);
+    group = curGroup;
+    arg->driver = this;
+  }
   void eval() {val = logic_cast(*res); Condition::eval();} //eval globally
-  void eval(std::vector<Condition*> &changed) { //eval locally into changed
+  bool near(ConstNumber margin) const {return ABS(*res-ONE) < margin;}
+  void check(std::vector<Condition*> &changed) { //eval locally into changed
     bool tmp = logic_cast(*res);
     if(val != tmp) {
       val = tmp;
       changed.push_back(this);
+      cross();
     }
   }
+  ConstNumber crossed() const {return tCross;}
+  void load(FILE *in) { //restore the logic value and the conductivities
+    get(in, val);
+    get(in, tCross);
+    apply(); //the loaded gates know whether they rest
+  }
+  size_t next() const;
+  void probe(); //record polynomials of res for dense output
   void print() const {
-    std::cerr << "res=" << pointer(res) << " Gn=" << pointer(Gn)
-              << " Gp=" << pointer(Gp);
+    std::cerr << "res=" << pointer(res) << " Gn=" << pointer(&arg->Gn)
+              << " Gp=" << pointer(&arg->Gp);
+  }
+  void save(FILE *out) const {
+    put(out, val);
+    put(out, tCross);
   }
+  void schedule(size_t step) {due = step;}
+  bool scheduled(size_t step) const {return due == step;}
+  void trace(Dae *dae) {traces.push_back(dae);}
+  Number value(ConstNumber) const;
+  void wake();
 };
 
 class Event: public Condition { //discrete events (e.g. 1, 1, 0)
   Number tn;
 public:
-  Event(ConstNumber t, bool val, Number *Gn, Number *Gp): tn(t),
-    Condition(val, Gn, Gp) {}
+  Event(ConstNumber t, bool val, Arg *arg): tn(t), Condition(val, arg) {}
   bool active() const {return tn<=t;} //is still active?
+  const Arg *input() const {return arg;}
+  ConstNumber time() const {return tn;}
+  bool value() const {return val;}
   bool operator<(const Event &event) const {return tn<event.tn;}
   void print() const {
-    std::cerr << "tn=" << tn << " val=" << val << " Gn=" << pointer(Gn)
-              << " Gp=" << pointer(Gp);
+    std::cerr << "tn=" << tn << " val=" << val << " Gn=" << pointer(&arg->Gn)
+              << " Gp=" << pointer(&arg->Gp);
   }
 };
 
@@ -101,15 +138,17 @@ public:
 class Assignment: ConditionCh { //for sum assignments
   Sum expr;
 public:
+  using ConditionCh::operator new;
+  using ConditionCh::operator delete;
   Assignment() {res = expr.result();}
   void add(const Number *num) {expr.add(num);}
   void eval() {expr.eval();}
   void print() const {expr.print();}
   void reserve(size_t size) {expr.reserve(size);}
   const Number *result() const {return res;}
+  void trace(Dae *dae) {ConditionCh::trace(dae);}
   void set_out(Arg *arg) { //bind to affected inputs
-    Gn = &arg->Gn;
-    Gp = &arg->Gp;
+    this->arg = arg;
     arg->N = const_cast<Number*>(res);
     ConditionCh::add();
   }
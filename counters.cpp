@@ -0,0 +1,127 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "counters.h"
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+using namespace std;
+
+bool Counters::bEnabled = false;
+vector<Counters*> Counters::all;
+pthread_mutex_t Counters::mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *names[] = {"cycles", "instructions", "LLC misses",
+  "branch misses"};
+static const char *scopes[] = {"solve", "conditions", "output"};
+
+static int open_event(unsigned long long config, int group) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.read_format = PERF_FORMAT_GROUP;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return syscall(__NR_perf_event_open, &attr, 0, -1, group, 0); //this thread
+}
+
+Counters::Counters(): leader(-1) {
+  static const unsigned long long configs[] = {PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES};
+  memset(sums, 0, sizeof(sums));
+  for(size_t i = 0; i < EVENTS; ++i) {
+    int fd = open_event(configs[i], leader);
+    if(fd < 0) continue; //e.g. unsupported by a virtual machine
+    if(leader < 0) leader = fd;
+    opened.push_back(Event(i));
+  }
+  pthread_mutex_lock(&mutex);
+  all.push_back(this);
+  pthread_mutex_unlock(&mutex);
+}
+
+Counters::~Counters() {
+  if(leader >= 0) close(leader); //the group is closed with its members
+}
+
+Counters &Counters::local() { //counters of the calling thread
+  static __thread Counters *counters = NULL;
+  if(!counters) counters = new Counters;
+  return *counters;
+}
+
+bool Counters::read(uint64_t *values) { //values of the opened events
+  uint64_t buffer[EVENTS+1]; //nr, values
+  size_t size = (opened.size()+1)*sizeof(uint64_t);
+  if(leader < 0 || ::read(leader, buffer, size) != (ssize_t)size) return false;
+  for(size_t i = 0; i < opened.size(); ++i) values[opened[i]] = buffer[i+1];
+  return true;
+}
+
+void Counters::mark() {
+  if(!read(start)) memset(start, 0, sizeof(start));
+}
+
+void Counters::add(Scope scope) {
+  uint64_t values[EVENTS];
+  if(!read(values)) return;
+  for(size_t i = 0; i < opened.size(); ++i) {
+    Event event = opened[i];
+    sums[scope][event] += values[event]-start[event];
+  }
+}
+
+void Counters::report() { //sums of all threads
+  if(!bEnabled) return;
+  pthread_mutex_lock(&mutex);
+  bool bOpened[EVENTS] = {false};
+  uint64_t sums[SCOPES][EVENTS];
+  memset(sums, 0, sizeof(sums));
+  vector<Counters*>::const_iterator it, end = all.end();
+  for(it = all.begin(); it != end; ++it) {
+    const Counters *counters = *it;
+    for(size_t i = 0; i < counters->opened.size(); ++i)
+      bOpened[counters->opened[i]] = true;
+    for(size_t s = 0; s < SCOPES; ++s)
+      for(size_t e = 0; e < EVENTS; ++e) sums[s][e] += counters->sums[s][e];
+  }
+  pthread_mutex_unlock(&mutex);
+  if(!bOpened[CYCLES] && !bOpened[INSTRUCTIONS] && !bOpened[LLC_MISSES] &&
+     !bOpened[BRANCH_MISSES]) {
+    cerr << "Hardware counters: unavailable" << endl;
+    return;
+  }
+  for(size_t s = 0; s < SCOPES; ++s) {
+    cerr << "Hardware counters (" << scopes[s] << "):";
+    const char *sep = " ";
+    for(size_t e = 0; e < EVENTS; ++e)
+      if(bOpened[e]) {
+        cerr << sep << sums[s][e] << " " << names[e];
+        sep = ", ";
+      }
+    if(bOpened[CYCLES] && bOpened[INSTRUCTIONS] && sums[s][CYCLES])
+      cerr << ", " << (Number)sums[s][INSTRUCTIONS]/sums[s][CYCLES] << " IPC";
+    cerr << endl;
+  }
+}
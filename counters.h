@@ -0,0 +1,55 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __COUNTERS_H__
+#define __COUNTERS_H__
+
+#include "main.h"
+#include <pthread.h>
+#include <stdint.h>
+
+//hardware counters of the calling thread (perf_event_open), e.g.
+//counters = on; each thread sums its own counts, which are aggregated in
+//the statistics; the counters are skipped if the kernel refuses them:
+class Counters {
+public:
+  enum Event {CYCLES, INSTRUCTIONS, LLC_MISSES, BRANCH_MISSES, EVENTS};
+  enum Scope {SOLVE, CONDITIONS, OUTPUT, SCOPES};
+private:
+  static bool bEnabled;
+  static std::vector<Counters*> all;
+  static pthread_mutex_t mutex;
+  int leader;
+  std::vector<Event> opened; //order of the values read from the group
+  uint64_t start[EVENTS], sums[SCOPES][EVENTS];
+  bool read(uint64_t *);
+  static Counters &local();
+  void mark();
+  void add(Scope);
+public:
+  Counters();
+  ~Counters();
+  static void begin() {if(bEnabled) local().mark();}
+  static void enable(bool bOn) {bEnabled = bOn;}
+  static void end(Scope scope) {if(bEnabled) local().add(scope);}
+  static void report();
+};
+
+#endif
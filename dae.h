@@ -22,55 +22,98 @@
 #define __DAE_H__
 
 #include "main.h"
+#include "network.h"
+#include "stat.h"
 
-class Dae {
-  static size_t nAlgs, nODEs;
+class Dae: public Tagged<Memory::DAES> {
+  static __thread size_t nAlgs, nODEs; //counts of the elaborating thread
   bool bODE;
   unsigned short idx;
   std::vector<const Number*> args;
   const Number *i_val; //total current
+  const Network *net; //merged transistors of compound gates
   Number cur_val, *G, res; //term value, conductivity and result
-  void fill(std::vector<std::vector<Number> > &m, size_t ORD) {
+  Number start, slope; //result before the step and the first-order term
+  std::vector<Number> *poly; //terms of the last step (dense output)
+  void reg() {cur_daes->push_back(this);}
+  friend class Codegen;
+  friend class Gate;
+  template<size_t> friend size_t fused(std::vector<std::vector<Number> > &,
+                                       Gate *);
+public:
+  static void add_counts(size_t algs, size_t odes) {
+    nAlgs += algs;
+    nODEs += odes;
+  }
+  static size_t algs() {return nAlgs;}
+  static ConstNumber mult(std::vector<std::vector<Number> > &m, size_t idx,
+                          size_t ORD) { //outer coefficient of N = idx+1
     std::vector<Number> &mults = m[idx];
     size_t size = mults.size();
     if(size < ORD) { //if a coefficient of higher order needed
       ConstNumber coeff = ::coeff[idx];
       while(size < ORD) mults.push_back(coeff/++size); //add including previous
     }
+    return mults[ORD-1];
   }
-  void reg() {cur_daes->push_back(this);}
-public:
-  static size_t algs() {return nAlgs;}
   static size_t odes() {return nODEs;}
   Dae(size_t N, Dae *i, Number *G, ConstNumber iv = 0): bODE(true),
-   G(G), res(iv), i_val(&i->res), idx(N-1) {
+   idx(N-1), i_val(&i->res), net(NULL), G(G), res(iv), poly(NULL) {
     ++nODEs;
     i->add(&cur_val); //term value is also used for the calculation of current
     if(!G) this->G = new Number;
     reg();
   }
-  Dae(): bODE(false) {++nAlgs; reg();}
+  Dae(): bODE(false), net(NULL), G(&Gi), poly(NULL) {++nAlgs; reg();}
   void add(const Number *num) {args.push_back(num);}
-  void add_term() {res += cur_val;}
+  void copy(const Dae *dae) { //the step of an equal one (see Gate::equals)
+    res = dae->res;
+    cur_val = dae->cur_val;
+    start = dae->start;
+    slope = dae->slope;
+    if(bODE && (!args.empty() || net)) *G = *dae->G; //computed in first_term
+  }
+  void add_term() {
+    res += cur_val;
+    if(poly) poly->push_back(cur_val);
+  }
   void eval_term(std::vector<std::vector<Number> > &mults, size_t ORD) {
+    if(bODE) mult(mults, idx, ORD); //coefficients up to ORD
+    eval_term(&mults[0], ORD);
+  }
+  //with the outer coefficients of all orders up to ORD (e.g. shared_mults):
+  void eval_term(const std::vector<Number> *mults, size_t ORD) {
     if(bODE) { //evaluate the term (see Chapter 5.4)
       cur_val *= *G;
       cur_val += *i_val;
-      fill(mults, ORD);
       cur_val *= mults[idx][ORD-1]; //outer coefficient
+      if(ORD == 1) slope = cur_val;
     }
     else { //expression for current
       sum(args, res);
       if(ORD == 1) res += U;
-      res *= Gi;
+      res *= *G; //Gi unless varied
     }
   }
   void first_term() { //init before the first term
     if(bODE) {
-      cur_val = res;
+      cur_val = start = res;
+      if(poly) poly->clear();
       if(!args.empty()) sum(args, *G);
+      else if(net) *G = net->eval();
     }
   }
+  void heap(size_t *bytes) const { //of its containers by Memory::Tag
+    bytes[Memory::DAES] += Memory::heap(args);
+    if(poly) bytes[Memory::DAES] += sizeof(*poly)+Memory::heap(*poly);
+    if(net) bytes[Memory::NETWORKS] += net->heap();
+  }
+  ConstNumber initial() const {return start;}
+  void load(FILE *in) {
+    get(in, res);
+    get(in, cur_val);
+    if(G != &Gi) get(in, *G);
+  }
   bool is_ode() const {return bODE;}
   void labg() { //if debug, create human-readable pointer description
     if(bDebug && pointers[G] == "") {
@@ -94,58 +137,438 @@ public:
     std::cerr << std::endl;
   }
   void reserve(size_t size) {args.reserve(size);}
+  ConstNumber rate() const {return slope;}
+  void save(FILE *out) const {
+    put(out, res);
+    put(out, cur_val);
+    if(G != &Gi) put(out, *G);
+  }
+  void record() {if(!poly) poly = new std::vector<Number>;}
   const Number *result() const {return &res;}
-  void set_out(Arg *res) {new ConditionCh(&this->res, res);}
+  void scale(ConstNumber r) {if(bODE) res *= r;} //initial values of a new U
+  void set_net(const Network *net) {this->net = net;}
+  void set_out(Arg *res) {(new ConditionCh(&this->res, res))->trace(this);}
+  void vary(ConstNumber f) {if(!bODE) G = new Number(Gi/f);} //ri*f
+  Number value(ConstNumber x) const { //the result at x of the last step
+    Number val = 0;
+    std::vector<Number>::const_reverse_iterator it, end = poly->rend();
+    for(it = poly->rbegin(); it != end; ++it) val = (val+*it)*x; //Horner
+    return start+val;
+  }
   ConstNumber term() {return cur_val;}
 };
 
-class Gate {
+class Gate: public Tagged<Memory::GATES> {
   std::vector<Dae*> daes;
+  std::vector<Arg*> ins; //inputs until the fanouts are linked (or if mixed)
+  Arg *out;
+  Type type;
+  std::vector<size_t> sizes; //groups of AOI and OAI
+  bool bSettled; //first-order terms of the last step were below STILL
+  bool bLogic; //rests at its logic value until an input changes (mixed)
+  Number q; //charge drawn from U (power analysis)
+  size_t maxOrd; //the highest order reached (profiling)
+  size_t next; //predicted order of the next step (0 ~ unknown)
+  size_t fanin; //of a NAND, NOR or NOT solved by fused (0 ~ taylor)
+  size_t family; //of equal structure in its group (-1 ~ not shared)
+  std::vector<const Number*> reads; //numbers of other gates (dedup)
+  Number dq; //charge of the last step (shared if dedup)
+  Kernel kernel; //generated Taylor step (if any)
+  std::vector<Number*> wires; //numbers of the kernel
+  friend class Codegen;
+  template<size_t> friend size_t fused(std::vector<std::vector<Number> > &,
+                                       Gate *);
+  friend size_t predict(std::vector<std::vector<Number> > &, Gate *);
+  friend size_t solve_fused(std::vector<std::vector<Number> > &, Gate *);
+  friend size_t series(std::vector<std::vector<Number> > &, Gate *, size_t,
+                       Number &);
   friend size_t taylor(std::vector<std::vector<Number> > &, Gate *);
   friend void print_debug();
+  friend Group;
   friend Term;
+  bool logic() const { //of the current inputs
+    static __thread std::vector<bool> *in = NULL;
+    if(!in) in = new std::vector<bool>;
+    in->clear();
+    std::vector<Arg*>::const_iterator it, end = ins.end();
+    for(it = ins.begin(); it != end; ++it) in->push_back((*it)->Gn == Gopen);
+    return ::logic(type, sizes, *in);
+  }
+  void rest() { //switch a settled gate at a rail to its logic value
+    if(logic() != logic_cast(*out->N) ||
+       out->driver->near(-U*DEFAULT_SETTLE_MARGIN)) return;
+    bLogic = true;
+    std::vector<Dae*>::const_iterator it, end = daes.end();
+    for(it = daes.begin(); it != end; ++it) (*it)->first_term(); //no terms
+  }
 public:
-  Gate() {cur_daes = &daes;}
+  Gate(const std::vector<Arg*> &ins, Arg *out, Type type,
+       const std::vector<size_t> &sizes): ins(ins), out(out), type(type),
+    sizes(sizes), bSettled(false), bLogic(false), q(0), maxOrd(0), next(0),
+    fanin(0), family(-1), dq(0), kernel(NULL) {
+    cur_daes = &daes;
+  }
+  ConstNumber charge() const {return q;}
+  bool equals(const Gate *gate) const { //its state and inputs before the step
+    for(size_t j = 0; j < daes.size(); ++j) //the step of gate is done
+      if(daes[j]->bODE && daes[j]->res != gate->daes[j]->start) return false;
+    for(size_t k = 0; k < reads.size(); ++k)
+      if(*reads[k] != *gate->reads[k]) return false;
+    return true;
+  }
+  void fuse() { //recognize the capacitors of Term::make_ser and make_par
+    size_t N = daes.size()-2;
+    fanin = 0;
+    if(!bFused || daes.size() < 3 || N > DEFAULT_FUSED) return;
+    Dae *i = daes[0];
+    if(i->bODE || i->args.size() != N+1 || i->poly) return;
+    for(size_t k = 1; k <= N+1; ++k) {
+      Dae *uc = daes[k];
+      if(!uc->bODE || uc->i_val != &i->res || i->args[k-1] != &uc->cur_val ||
+         uc->poly || uc->net || uc->idx != (k <= N? 0: N-1)) return;
+      if(uc->args.size() != (k <= N? 0: N)) return; //series or merged
+    }
+    fanin = N;
+  }
+  void share(const Gate *gate) { //take the step of an equal gate
+    for(size_t j = 0; j < daes.size(); ++j) daes[j]->copy(gate->daes[j]);
+    bSettled = gate->bSettled;
+    dq = gate->dq;
+    q += dq;
+  }
+  bool recorded() const { //terms of a capacitor are kept for dense output
+    for(size_t j = 0; j < daes.size(); ++j) if(daes[j]->poly) return true;
+    return false;
+  }
+  void shape(std::vector<size_t> &key) { //equal for gates with equal steps
+    std::map<const Number*,size_t> own;
+    for(size_t j = 0; j < daes.size(); ++j) {
+      own[&daes[j]->res] = 2*j+1;
+      own[&daes[j]->cur_val] = 2*j+2;
+    }
+    reads.clear();
+    std::vector<Dae*>::const_iterator it, end = daes.end();
+    for(it = daes.begin(); it != end; ++it) {
+      Dae *dae = *it;
+      std::vector<const Number*> nums(dae->args);
+      key.push_back(dae->bODE);
+      key.push_back(nums.size());
+      if(dae->bODE) {
+        key.push_back(dae->idx);
+        nums.push_back(dae->i_val);
+        if(dae->net) {
+          dae->net->shape(key);
+          nums.insert(nums.end(), dae->net->inputs().begin(),
+                      dae->net->inputs().end());
+        }
+        else if(nums.size() == 1) nums.push_back(dae->G); //not computed
+      }
+      else nums.push_back(dae->G);
+      std::vector<const Number*>::const_iterator num, nend = nums.end();
+      for(num = nums.begin(); num != nend; ++num) {
+        std::map<const Number*,size_t>::const_iterator o = own.find(*num);
+        key.push_back(o == own.end()? 0: o->second);
+        if(o == own.end()) reads.push_back(*num);
+      }
+    }
+  }
+  void heap(size_t *bytes) const { //of its containers and daes
+    bytes[Memory::GATES] += Memory::heap(daes)+Memory::heap(ins)+
+      Memory::heap(sizes)+Memory::heap(reads)+Memory::heap(wires);
+    std::vector<Dae*>::const_iterator it, end = daes.end();
+    for(it = daes.begin(); it != end; ++it) (*it)->heap(bytes);
+  }
+  const std::vector<const Number*> &inputs() const {return reads;} //of shape
+  void load(FILE *in) {
+    size_t size;
+    get(in, size);
+    if(size != daes.size())
+      error_exit("Checkpoint does not match the circuit.");
+    get(in, q);
+    get(in, bSettled);
+    get(in, bLogic); //a resting gate stays at its logic value
+    get(in, next);
+    std::vector<Dae*>::const_iterator it, end = daes.end();
+    for(it = daes.begin(); it != end; ++it) (*it)->load(in);
+  }
+  void scale(ConstNumber r) {
+    std::vector<Dae*>::const_iterator it, end = daes.end();
+    for(it = daes.begin(); it != end; ++it) (*it)->scale(r);
+  }
+  void vary(ConstNumber f) {
+    std::vector<Dae*>::const_iterator it, end = daes.end();
+    for(it = daes.begin(); it != end; ++it) (*it)->vary(f);
+  }
+  size_t order() const {return maxOrd;}
+  void wake() { //an input changed: integrate from the rest, orders unknown
+    bLogic = false;
+    next = 0;
+  }
+  const Arg *output() const {return out;}
   void reserve(size_t size) {daes.reserve(size);}
+  void save(FILE *out) const {
+    put(out, daes.size());
+    put(out, q);
+    put(out, bSettled);
+    put(out, bLogic);
+    put(out, next);
+    std::vector<Dae*>::const_iterator it, end = daes.end();
+    for(it = daes.begin(); it != end; ++it) (*it)->save(out);
+  }
   size_t size() const {return daes.size();}
 };
 
-class Group {
+class Group: public Tagged<Memory::GROUPS> {
   std::vector<Assignment*> assignments;
   std::vector<Condition*> changed;
   std::vector<ConditionCh*> conditions;
   std::vector<Gate*> gates;
-  size_t sz;
+  std::vector<std::vector<ConditionCh*> > wheel; //conditions due in a step
+  std::vector<std::vector<Gate*> > solved; //in this step, per family (dedup)
+  size_t sz, nLogic; //steps of gates resting at their logic values (mixed)
+  size_t nShared; //steps of gates taken from equal gates (dedup)
+  bool bSettled; //no gate changes and no input is near its threshold
+  Load *usage; //solve times and orders if profiled
+  bool near() const { //is any result close to the logical threshold?
+    ConstNumber margin = -U*DEFAULT_SETTLE_MARGIN;
+    std::vector<ConditionCh*>::const_iterator it, end = conditions.end();
+    for(it = conditions.begin(); it != end; ++it)
+      if((*it)->near(margin)) return true;
+    return false;
+  }
+  friend class Codegen;
   friend void init_threads();
   friend void print_debug();
 public:
-  Group(): sz(0) { //cur* variables are used in parser and single-threaded code
-    curGroup = this;
-    cur_assignments = &assignments;
-    cur_changed = &changed;
-    cur_conditions = &conditions;
+  Group(): wheel(DEFAULT_WHEEL), sz(0), nLogic(0), nShared(0),
+    bSettled(false), usage(NULL) {
+    select();
+  }
+  void add(const std::vector<Arg*> &ins, Arg *out, Type type,
+           const std::vector<size_t> &sizes) {
+    gates.push_back(new Gate(ins, out, type, sizes));
+    out->gate = gates.back();
   }
-  void add() {gates.push_back(new Gate);}
   void add_size() {sz += gates.back()->size();}
   std::vector<Gate*>::iterator begin() {return gates.begin();}
   std::vector<Gate*>::iterator end() {return gates.end();}
+  void check() { //only the scheduled conditions can cross ONE in this step
+    std::vector<ConditionCh*> &slot = wheel[curStep%DEFAULT_WHEEL];
+    std::vector<ConditionCh*>::const_iterator it, end = slot.end();
+    for(it = slot.begin(); it != end; ++it) {
+      ConditionCh *cond = *it;
+      if(!cond->scheduled(curStep)) continue; //woken or moved meanwhile
+      cond->check(changed);
+      schedule(cond, cond->next());
+    }
+    slot.clear();
+  }
+  void classify() { //families of gates with equal structure (dedup)
+    std::map<std::vector<size_t>,size_t> families;
+    std::vector<size_t> sizes;
+    std::vector<Gate*>::const_iterator it, end = gates.end();
+    for(it = gates.begin(); it != end; ++it) {
+      std::vector<size_t> key;
+      if((*it)->recorded()) continue;
+      (*it)->shape(key);
+      size_t id = families.insert(make_pair(key, sizes.size())).first->second;
+      if(id == sizes.size()) sizes.push_back(0);
+      ++sizes[id];
+      (*it)->family = id;
+    }
+    for(it = gates.begin(); it != end; ++it) //alone in its family
+      if((*it)->family != (size_t)-1 && sizes[(*it)->family] < 2)
+        (*it)->family = -1;
+    solved.assign(sizes.size(), std::vector<Gate*>());
+  }
+  void fuse() { //the gates solved by fused
+    std::vector<Gate*>::const_iterator it, end = gates.end();
+    for(it = gates.begin(); it != end; ++it) (*it)->fuse();
+  }
+  void heap(size_t *bytes) const { //of its containers and gates
+    size_t &size = bytes[Memory::GROUPS];
+    size += Memory::heap(assignments)+Memory::heap(changed)+
+      Memory::heap(conditions)+Memory::heap(gates)+Memory::heap(wheel)+
+      Memory::heap(solved);
+    for(size_t i = 0; i < wheel.size(); ++i) size += Memory::heap(wheel[i]);
+    for(size_t i = 0; i < solved.size(); ++i) size += Memory::heap(solved[i]);
+    std::vector<Gate*>::const_iterator it, end = gates.end();
+    for(it = gates.begin(); it != end; ++it) (*it)->heap(bytes);
+  }
+  size_t logic() const {return nLogic;}
+  size_t shared() const {return nShared;}
+  void link() { //register the gates in the fanouts of their inputs
+    std::vector<Gate*>::const_iterator it, end = gates.end();
+    for(it = gates.begin(); it != end; ++it) {
+      Gate *gate = *it;
+      std::vector<Arg*>::const_iterator in, iend = gate->ins.end();
+      for(in = gate->ins.begin(); in != iend; ++in)
+        (*in)->fanout.push_back(gate->out);
+      if(!bMixed) std::vector<Arg*>().swap(gate->ins);
+    }
+  }
+  void load(FILE *in) { //the assignments are evaluated, all conditions checked
+    size_t nGates, nConditions;
+    get(in, nGates);
+    get(in, nConditions);
+    if(nGates != gates.size() || nConditions != conditions.size())
+      error_exit("Checkpoint does not match the circuit.");
+    get(in, nLogic);
+    get(in, nShared);
+    std::vector<Gate*>::const_iterator it, end = gates.end();
+    for(it = gates.begin(); it != end; ++it) (*it)->load(in);
+    assign(&assignments);
+    std::vector<ConditionCh*>::const_iterator cond, cend = conditions.end();
+    for(cond = conditions.begin(); cond != cend; ++cond) (*cond)->load(in);
+    start();
+  }
   void perform_conditions() {cur_changed = &changed; ::perform_conditions();}
+  void profile(Load *usage) {this->usage = usage;}
   void reserve_assignments(size_t size) {assignments.reserve(size);}
+  void select() { //cur* variables are used in parser and single-threaded code
+    curGroup = this;
+    cur_assignments = &assignments;
+    cur_changed = &changed;
+    cur_conditions = &conditions;
+  }
   void reserve_changed(size_t size) {changed.reserve(size);}
   void reserve_conditions(size_t size) {conditions.reserve(size);}
   void reserve_gates(size_t size) {gates.reserve(size);}
+  void scale(ConstNumber r) { //capacitor voltages for a new U
+    std::vector<Gate*>::const_iterator it, end = gates.end();
+    for(it = gates.begin(); it != end; ++it) (*it)->scale(r);
+  }
+  void save(FILE *out) const {
+    put(out, gates.size());
+    put(out, conditions.size());
+    put(out, nLogic);
+    put(out, nShared);
+    std::vector<Gate*>::const_iterator it, end = gates.end();
+    for(it = gates.begin(); it != end; ++it) (*it)->save(out);
+    std::vector<ConditionCh*>::const_iterator cond, cend = conditions.end();
+    for(cond = conditions.begin(); cond != cend; ++cond) (*cond)->save(out);
+  }
+  bool share(Gate *gate) { //take the step of an equal gate solved before
+    std::vector<Gate*> &family = solved[gate->family];
+    std::vector<Gate*>::const_reverse_iterator it, end = family.rend();
+    size_t n = 0;
+    for(it = family.rbegin(); it != end && n < DEFAULT_DEDUP; ++it, ++n)
+      if(gate->equals(*it)) {
+        gate->share(*it);
+        return true;
+      }
+    return false;
+  }
+  void schedule(ConditionCh *cond, size_t step) {
+    cond->schedule(step);
+    wheel[step%DEFAULT_WHEEL].push_back(cond);
+  }
+  bool settled() const {return bSettled;}
   size_t size() const {return sz;}
+  void start() { //check all conditions in the current step
+    std::vector<ConditionCh*>::const_iterator it, end = conditions.end();
+    for(it = conditions.begin(); it != end; ++it) schedule(*it, curStep);
+  }
   size_t solve(std::vector<std::vector<Number> > &mults) {
     size_t ORD, MAXORD = 0; //solve the group of equations:
+    bool bSteady = SETTLE > 0;
+    Number tStart = usage? microtime(): 0;
+    std::vector<std::vector<Gate*> >::iterator family, fend = solved.end();
+    for(family = solved.begin(); family != fend; ++family) family->clear();
     std::vector<Gate*>::const_iterator it, end = gates.end();
     for(it = gates.begin(); it != end; ++it) {
-      ORD = taylor(mults, *it);
-      if(ORD > MAXORD) MAXORD = ORD;
+      Gate *gate = *it;
+      if(gate->bLogic) { //settled gates keep their voltages
+        ++nLogic;
+        continue;
+      }
+      if(gate->family != (size_t)-1 && share(gate)) ++nShared;
+      else {
+        Number q = gate->q;
+        if(gate->kernel)
+          ORD = gate->kernel(&gate->wires[0], &gate->bSettled, &gate->q);
+        else if(gate->fanin) ORD = solve_fused(mults, gate);
+        else ORD = bPredict? predict(mults, gate): taylor(mults, gate);
+        if(ORD > MAXORD) MAXORD = ORD;
+        if(usage) {
+          usage->count(ORD);
+          if(ORD > gate->maxOrd) gate->maxOrd = ORD;
+        }
+        gate->dq = gate->q-q;
+      }
+      bSteady = bSteady && gate->bSettled;
+      if(bMixed && gate->bSettled) gate->rest();
+      if(gate->family != (size_t)-1 && !gate->bLogic) //rest restarts the terms
+        solved[gate->family].push_back(gate);
     }
     assign(&assignments); //eval conditions locally (thread-safe):
-    eval_conditions(&conditions, &changed);
+    check();
+    bSettled = bSteady && changed.empty() && !near();
+    if(usage) usage->add(microtime()-tStart);
     return MAXORD;
   }
 };
 
+inline void Arg::force() { //apply a stuck-at or stuck-open/short fault
+  if(fn >= 0) Gn = fn? Gopen: Gclosed;
+  if(fp >= 0) Gp = fp? Gopen: Gclosed;
+}
+
+inline void Arg::wake() const { //re-predict the gates driven by this net
+  if(monitor) notify(monitor);
+  std::vector<Arg*>::const_iterator it, end = fanout.end();
+  for(it = fanout.begin(); it != end; ++it) {
+    if((*it)->driver) (*it)->driver->wake();
+    if((*it)->gate) (*it)->gate->wake(); //mixed mode
+  }
+}
+
+inline void ConditionCh::cross() { //v(x) = v0+d*x+c*x*x passes v(1) = *res
+  Number v0 = 0, d = 0, x = 1;
+  std::vector<Dae*>::const_iterator it, end = traces.end();
+  for(it = traces.begin(); it != end; ++it) {
+    v0 += (*it)->initial();
+    d += (*it)->rate();
+  }
+  Number c = *res-v0-d, a = v0-ONE;
+  if(ABS(c) <= EPS) { //linear
+    if(d) x = -a/d;
+  }
+  else {
+    Number disc = d*d-4*c*a;
+    if(disc >= 0) { //the root in [0, 1]
+      Number sq = sqrtl(disc), x1 = (-d-sq)/(2*c), x2 = (-d+sq)/(2*c);
+      x = x1 >= 0 && x1 <= 1? x1: x2;
+    }
+  }
+  if(!(x >= 0 && x <= 1)) x = 1; //only the end of the step is known
+  tCross = t+x*dt;
+}
+
+//the first step in which ONE may be crossed; the first-order terms cannot
+//be extrapolated since the responses of gates are S-shaped, but no voltage
+//changes faster than the slew bound:
+inline size_t ConditionCh::next() const {
+  Number steps = ABS(ONE-*res)/SLEW;
+  size_t n = DEFAULT_WHEEL-1; //recheck at the horizon
+  if(steps < n) n = steps < 1? 1: (size_t)steps;
+  return curStep+n;
+}
+
+inline void ConditionCh::probe() {
+  std::vector<Dae*>::const_iterator it, end = traces.end();
+  for(it = traces.begin(); it != end; ++it) (*it)->record();
+}
+
+inline Number ConditionCh::value(ConstNumber x) const {
+  Number val = 0;
+  std::vector<Dae*>::const_iterator it, end = traces.end();
+  for(it = traces.begin(); it != end; ++it) val += (*it)->value(x);
+  return val;
+}
+
+inline void ConditionCh::wake() { //inputs changed, check in the current step
+  if(due != curStep) group->schedule(this, curStep);
+}
+
 #endif
@@ -35,5 +35,23 @@ const unsigned DEFAULT_MAX_THREADS = 96, DEFAULT_TEST = 3, DEFAULT_THREADS = 0,
 
 //internal details:
 const unsigned DEFAULT_MINCOEFF = 32;
+const unsigned DEFAULT_MARK_STATEMENTS = 1024; //memory sampling when streaming
+const unsigned DEFAULT_MAX_XOR = 4; //XOR networks grow exponentially
+const unsigned DEFAULT_ELAB_CHUNK = 4096; //terms lowered at once by a thread
+const unsigned DEFAULT_STIMULUS_BUF = 65536; //read buffer of stimulus files
+const unsigned DEFAULT_BISECT = 40; //iterations locating a crossing in a step
+const unsigned DEFAULT_WHEEL = 64; //steps in which conditions are scheduled
+const unsigned DEFAULT_RECORD = 1000; //steps between checkpoints of a record
+const unsigned DEFAULT_MEMORY_STEPS = 1000; //between memory samples
+const unsigned DEFAULT_PROFILE_TOP = 10; //gates of the highest orders
+const unsigned DEFAULT_ORDERS = 64; //shared coefficients of predicted orders
+const unsigned DEFAULT_FUSED = 4; //the highest fan-in of fused gates
+const unsigned DEFAULT_DEDUP = 4; //equal gates tried before solving one
+const char *const DEFAULT_CODEGEN_FLAGS = "-O2 -fPIC -shared"; //after $CXX
+const Number DEFAULT_SLEW = 2; //safety factor of the maximal change per step
+const Number DEFAULT_MIXED_SETTLE = 1e-6; //of U, settle of gates if mixed
+const Number DEFAULT_SETTLE_MARGIN = 0.1; //of U, from settled nets to ONE
+const Number DEFAULT_MEASURE_LOW = 0.1; //of U, rise and fall times
+const Number DEFAULT_MEASURE_HIGH = 0.9; //of U, rise and fall times
 
 #endif
@@ -22,22 +22,89 @@
 using namespace std;
 
 deque<Expr*> Expr::exprs;
+map<size_t,Statement*> Expr::pending;
+map<string,vector<Statement*> > Expr::waiting;
+set<string> Expr::defined;
+vector<string> Expr::fresh;
+size_t Expr::nStatements = 0, Expr::nLowered = 0;
 map<string,Arg*,num_greater> Expr::numbers;
 
-void Expr::transform() { //transform to class Term to lower memory usage
+void Expr::lower(deque<Expr*> &exprs) { //transform exprs to class Term
+  size_t size = 0;
   deque<Expr*>::const_iterator it, end = exprs.end();
+  for(it = exprs.begin(); it != end; ++it) size += (*it)->heap();
+  Memory::grow(Memory::EXPRS, size); //until they are released
   for(it = exprs.begin(); it != end; ++it) {
     Expr *expr = *it;
     expr->set_res(); //create the space for the result if not reserved yet
     switch(expr->type) {
       case ARGS: break; //not needed
       case BITS: if(expr->var != "") new Term(expr); break; //only if assigned
-      case XOR: expr->tran_xor(); break; //use basic gates
+      case GROUP: break; //arguments of AOI and OAI
+      case XOR: //use basic gates or the compound gate
+        if(bNative) new Term(expr);
+        else expr->tran_xor();
+        break;
       case VAR: break; //not needed
       default: new Term(expr); //basic gates
     }
   }
   for(it = exprs.begin(); it != end; ++it) delete *it;
+  Memory::shrink(Memory::EXPRS, size);
+}
+
+void Expr::statement() { //lower the statement as soon as its nets are resolved
+  if(!bStream || bOptimize) return; //optimization needs the whole netlist
+  Statement *stmt = new Statement;
+  stmt->exprs.swap(exprs); //the parser registers only the current statement
+  stmt->id = nStatements++;
+  stmt->unresolved = 0;
+  set<string> refs; //referenced nets which are not defined yet
+  deque<Expr*>::const_iterator it, end = stmt->exprs.end();
+  for(it = stmt->exprs.begin(); it != end; ++it) {
+    const Expr *expr = *it;
+    if(expr->type == VAR && expr->args.empty() && !defined.count(expr->var) &&
+       refs.insert(expr->var).second) {
+      waiting[expr->var].push_back(stmt);
+      ++stmt->unresolved;
+    }
+  }
+  vector<Statement*> ready;
+  if(stmt->unresolved) pending[stmt->id] = stmt;
+  else ready.push_back(stmt);
+  vector<string>::const_iterator name, last = fresh.end();
+  for(name = fresh.begin(); name != last; ++name) { //resolve waiting statements
+    map<string,vector<Statement*> >::iterator w = waiting.find(*name);
+    if(w == waiting.end()) continue;
+    vector<Statement*>::const_iterator st, stend = w->second.end();
+    for(st = w->second.begin(); st != stend; ++st)
+      if(!--(*st)->unresolved) ready.push_back(*st);
+    waiting.erase(w);
+  }
+  fresh.clear();
+  vector<Statement*>::const_iterator st, stend = ready.end();
+  for(st = ready.begin(); st != stend; ++st) { //Expr -> Term -> Dae at once
+    if(*st != stmt) pending.erase((*st)->id);
+    lower((*st)->exprs);
+    Term::lower();
+    delete *st;
+    if(++nLowered % DEFAULT_MARK_STATEMENTS == 0) mark_mem_sz();
+  }
+}
+
+void Expr::transform() { //transform to class Term to lower memory usage
+  if(bStream) { //nets which were never defined stay unresolved:
+    map<size_t,Statement*>::const_iterator it, end = pending.end();
+    for(it = pending.begin(); it != end; ++it) {
+      lower(it->second->exprs);
+      Term::lower();
+      delete it->second;
+    }
+    pending = map<size_t,Statement*>();
+    waiting = map<string,vector<Statement*> >();
+  }
+  defined = set<string>(); //e.g. inputs of stimuli before "stream = on"
+  lower(exprs);
   mark_mem_sz(); exprs = deque<Expr*>(); //mark memory usage if higher
 }
 
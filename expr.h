@@ -54,8 +54,18 @@ public: //sort not only literally but also by the first number
   }
 };
 
-class Expr {
+struct Statement { //top-level statement waiting for its nets (streaming)
+  std::deque<Expr*> exprs;
+  size_t id, unresolved; //number of referenced nets not defined yet
+};
+
+class Expr: public Tagged<Memory::EXPRS> {
   static std::deque<Expr*> exprs;
+  static std::map<size_t,Statement*> pending; //by the order of statements
+  static std::map<std::string,std::vector<Statement*> > waiting; //by net
+  static std::set<std::string> defined; //nets defined by parsed statements
+  static std::vector<std::string> fresh; //defined since the last statement
+  static size_t nStatements, nLowered;
   Arg *res;
   short iv; //initial value
   std::vector<bool> bits;
@@ -63,6 +73,9 @@ class Expr {
   std::string var; //assigned variable name
   Type type;
   void assign() {iv = -1; res = NULL; reg();} //assign default values
+  size_t heap() const { //bytes of its containers
+    return Memory::heap(bits)+Memory::heap(args)+Memory::heap(var);
+  }
   void reg() {exprs.push_back(this);}
   void set_res() {
     if(res == NULL_PTR()) error_exit("Cycle detected.");
@@ -85,15 +98,21 @@ class Expr {
       }
     }
   }
+  static void lower(std::deque<Expr*> &);
   void tran_xor();
   friend Term;
 public:
   static std::map<std::string,Arg*,num_greater> numbers;
+  static void define(const std::string &name) { //mark a net as resolved
+    if(defined.insert(name).second && bStream) fresh.push_back(name);
+  }
+  static void statement();
   static void transform();
   Expr(Expr *expr): type(ARGS) {assign(); add(expr);} //the first argument
   Expr(const std::string &var): type(VAR), var(var) {assign();} //named variable
   Expr(const std::string &var, const std::string &var2): type(VAR), var(var) {
     assign(); add(new Expr(var2)); set_res(); //assignment from a variable
+    define(var);
   }
   Expr(unsigned bit): type(BITS) {assign(); if(bit < 2) add(bit);} //the 1st bit
   void add(Expr *arg) {args.push_back(arg);}
@@ -101,7 +120,7 @@ public:
   Arg *out() {set_res(); return res;}
   void set_iv(const Expr *e) {if(!e->bits.empty()) iv = e->bits.front();}
   void set_type(Type type) {this->type = type;}
-  void set_var(const std::string &name) {var = name; set_res();}
+  void set_var(const std::string &name) {var = name; set_res(); define(name);}
 };
 
 #endif
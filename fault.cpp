@@ -0,0 +1,166 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "fault.h"
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+using namespace std;
+
+vector<Fault*> Fault::faults;
+vector<const Number*> Fault::outputs;
+vector<unsigned char> Fault::trace, Fault::cur;
+Number *Fault::detected = NULL;
+size_t Fault::injected = -1;
+size_t Fault::stuck = -1;
+bool Fault::stuckVal = false;
+FILE *Fault::good = NULL;
+
+void Fault::load(const string &file) { //the fault list
+  ifstream in(file.c_str());
+  if(!in) error_exit("Cannot open fault list \""+file+"\".");
+  string str, net, kind;
+  while(getline(in, str)) {
+    stringstream ss(str);
+    if(!(ss >> net) || net[0] == '#') continue; //empty lines and comments
+    if(!(ss >> kind) || (kind != "sa0" && kind != "sa1" && kind != "nopen" &&
+       kind != "popen" && kind != "nshort" && kind != "pshort"))
+      error_exit("Unknown fault of \""+net+"\" in \""+file+"\".");
+    faults.push_back(new Fault(net, kind));
+  }
+}
+
+void Fault::observe() { //shown outputs of gates in a deterministic order
+  map<string,Arg*,num_greater>::const_iterator it, end = Expr::numbers.end();
+  for(it = Expr::numbers.begin(); it != end; ++it)
+    if(it->second->driver && shown(it->first)) outputs.push_back(it->second->N);
+  if(outputs.empty()) error_exit("Fault simulation needs shown gate outputs.");
+  cur.resize((outputs.size()+7)/8);
+}
+
+void Fault::resolve() { //nets of the faults, checked before any fork
+  vector<Fault*>::const_iterator it, end = faults.end();
+  for(it = faults.begin(); it != end; ++it) {
+    map<string,Arg*,num_greater>::const_iterator arg =
+      Expr::numbers.find((*it)->net);
+    if(arg == Expr::numbers.end())
+      error_exit("Faulty net \""+(*it)->net+"\" does not exist.");
+    (*it)->arg = arg->second;
+  }
+}
+
+void Fault::simulate_good() { //trace of the good machine through a pipe
+  int fds[2];
+  if(pipe(fds)) error_exit("Cannot create a pipe for the good machine.");
+  cout.flush();
+  cerr.flush();
+  pid_t pid = fork();
+  if(pid < 0) error_exit("Cannot fork the good machine.");
+  if(!pid) { //writes the results and statistics as usual
+    close(fds[0]);
+    good = fdopen(fds[1], "w");
+    return;
+  }
+  close(fds[1]);
+  unsigned char buffer[DEFAULT_STIMULUS_BUF];
+  ssize_t n;
+  while((n = read(fds[0], buffer, sizeof(buffer))) > 0)
+    trace.insert(trace.end(), buffer, buffer+n);
+  close(fds[0]);
+  int status;
+  if(waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status))
+    error_exit("The good machine failed.");
+}
+
+//fork the good machine and then the faulty copies (at most one per processor
+//at a time); returns true in the parent, false in the simulating process:
+bool Fault::run() {
+  if(faults.empty()) return false;
+  SETTLE = 0; //steps of all copies have to match
+  observe();
+  resolve();
+  Record::full(); //the copies compare every step of the good machine
+  simulate_good();
+  if(good) return false;
+  size_t size = faults.size();
+  detected = static_cast<Number*>(mmap(NULL, size*sizeof(Number),
+    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+  if(detected == MAP_FAILED) error_exit("Cannot share the fault results.");
+  for(size_t i = 0; i < size; ++i) detected[i] = NAN;
+  size_t nCPUs = max(sysconf(_SC_NPROCESSORS_ONLN), 1L), running = 0;
+  size_t failed = 0;
+  for(size_t k = 0; k < size || running; ) {
+    if(k < size && running < nCPUs) {
+      pid_t pid = fork();
+      if(pid < 0) error_exit("Cannot fork a faulty copy.");
+      if(!pid) { //only the comparison matters
+        bOutput = false;
+        if(!freopen("/dev/null", "w", stdout) ||
+           !freopen("/dev/null", "w", stderr)) exit(1);
+        Source::reopen();
+        Checkpoint::set_file(""); //the good machine writes the snapshots
+        Record::set_dir("");
+        Memory::set_file("");
+        Profile::set_file("");
+        injected = k;
+        return false;
+      }
+      ++running;
+      ++k;
+    }
+    else {
+      int status;
+      if(wait(&status) < 0) break;
+      --running;
+      if(!WIFEXITED(status) || WEXITSTATUS(status)) ++failed;
+    }
+  }
+  if(failed) error_exit(num2str(failed)+" of "+num2str(size)+
+                        " faulty copies failed.");
+  size_t nDetected = 0;
+  for(size_t i = 0; i < size; ++i) {
+    cerr << "Fault " << faults[i]->net << " " << faults[i]->kind << ": ";
+    if(isnanl(detected[i])) cerr << "undetected" << endl;
+    else {
+      cerr << "detected at " << detected[i] << endl;
+      ++nDetected;
+    }
+  }
+  cerr << "Fault coverage: " << nDetected << "/" << size << " ("
+       << 100.L*nDetected/size << " %)" << endl;
+  return true;
+}
+
+void Fault::inject() { //force the conductivities after the initial conditions
+  if(injected >= faults.size()) return;
+  const Fault *fault = faults[injected];
+  Arg *arg = fault->arg;
+  const string &kind = fault->kind;
+  if(kind == "sa0" || kind == "sa1") {
+    arg->fn = kind == "sa1"; //n-channel conducts for one
+    arg->fp = kind == "sa0";
+    for(size_t i = 0, size = outputs.size(); i < size; ++i)
+      if(outputs[i] == arg->N) stuck = i, stuckVal = kind == "sa1";
+  }
+  else if(kind[0] == 'n') arg->fn = kind == "nshort";
+  else arg->fp = kind == "pshort";
+  arg->force();
+  arg->wake();
+}
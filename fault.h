@@ -0,0 +1,84 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __FAULT_H__
+#define __FAULT_H__
+
+#include "main.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+//fault simulation, e.g. faults = "faults.txt" with lines "net kind" where
+//kind is sa0 or sa1 (the gates driven by the net see it stuck), nopen or
+//popen (the transistors driven by the net never conduct) or nshort or pshort
+//(they always conduct); the good machine records the logic values of the
+//shown gate outputs in each step and every faulty copy is a forked process
+//which is dropped as soon as it differs from them (a shown net stuck at a
+//value is observed at that value); the copies are not packed into lanes of
+//one process since the state of the gates is bound by pointers during the
+//elaboration, a fork shares the elaborated circuit copy-on-write instead and
+//inherits the trace (one bit per observed net and step) from the parent:
+class Fault {
+  static std::vector<Fault*> faults;
+  static std::vector<const Number*> outputs; //observed nets
+  static std::vector<unsigned char> trace, cur; //packed values of the steps
+  static Number *detected; //shared by the forked copies (NAN ~ undetected)
+  static size_t injected; //index of the fault of this process
+  static size_t stuck; //index of the observed net stuck by the fault
+  static bool stuckVal;
+  static FILE *good; //the good machine writes its trace here
+  std::string net, kind;
+  Arg *arg; //the faulty net
+  static void observe();
+  static void resolve();
+  static void pack() { //logic values of the observed nets
+    cur.assign(cur.size(), 0);
+    for(size_t i = 0, size = outputs.size(); i < size; ++i)
+      if(logic_cast(*outputs[i])) cur[i/8] |= 1<<i%8;
+    if(stuck < outputs.size()) {
+      if(stuckVal) cur[stuck/8] |= 1<<stuck%8;
+      else cur[stuck/8] &= ~(1<<stuck%8);
+    }
+  }
+  static void simulate_good();
+public:
+  static void inject();
+  static void load(const std::string &);
+  static bool run();
+  static void step() { //compare the step with the good machine
+    if(good) {
+      pack();
+      fwrite(&cur[0], 1, cur.size(), good);
+    }
+    else if(injected < faults.size()) {
+      pack();
+      size_t size = cur.size(), pos = (curStep-1)*size;
+      if(pos+size <= trace.size() && memcmp(&trace[pos], &cur[0], size)) {
+        detected[injected] = t; //the copy is dropped
+        exit(0);
+      }
+    }
+  }
+  Fault(const std::string &net, const std::string &kind): net(net),
+    kind(kind), arg(NULL) {}
+};
+
+#endif
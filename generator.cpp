@@ -0,0 +1,109 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "generator.h"
+using namespace std;
+
+const unsigned long long Lfsr::masks[] = {0, 0, 0x3, 0x6, 0xC, 0x14, 0x30,
+  0x60, 0xB8, 0x110, 0x240, 0x500, 0x829, 0x100D, 0x2015, 0x6000, 0xD008,
+  0x12000, 0x20400, 0x40023, 0x90000, 0x140000, 0x300000, 0x420000, 0xE10000,
+  0x1200000, 0x2000023, 0x4000013, 0x9000000, 0x14000000, 0x20000029,
+  0x48000000, 0x80200003ULL};
+
+inline Number param(const vector<Number> &params, size_t i, ConstNumber def) {
+  return i < params.size()? params[i]: def; //optional parameter
+}
+
+inline size_t bus_width(const vector<Number> &params, const char *kind) {
+  Number width = params.empty()? 0: roundl(params[0]); //before the names
+  if(!(width >= 1 && width <= 64))
+    error_exit(string(kind)+" needs 1 <= width <= 64 and period > 0.");
+  return width;
+}
+
+void Generator::create(const string &name, const string &kind,
+                       const vector<Number> &params) {
+  if(kind == "clock") add(new Clock(name, params));
+  else if(kind == "counter") add(new Counter(name, params));
+  else if(kind == "lfsr") add(new Lfsr(name, params));
+  else if(kind == "random") add(new Random(name, params));
+  else if(kind == "reset") add(new Reset(name, params));
+  else error_exit("Unknown generator \""+kind+"\".");
+}
+
+Generator::Generator(const string &name, size_t width): t0(0) {
+  if(!width) names.push_back(name);
+  else for(size_t i = 0; i < width; ++i) names.push_back(name+num2str(i));
+  vector<string>::const_iterator it, end = names.end();
+  for(it = names.begin(); it != end; ++it) Expr::define(*it);
+}
+
+void Generator::bind() { //inputs are driven from the starting time
+  vector<string>::const_iterator it, end = names.end();
+  for(it = names.begin(); it != end; ++it) {
+    map<string,Arg*,num_greater>::const_iterator arg = Expr::numbers.find(*it);
+    if(arg == Expr::numbers.end()) {
+      cerr << "Warning: Generated input \"" << *it << "\" is not used." << endl;
+      args.push_back(NULL);
+    }
+    else args.push_back(arg->second);
+  }
+  vals.assign(names.size(), -1);
+  t0 = t;
+  start();
+}
+
+Clock::Clock(const string &name, const vector<Number> &params):
+  Generator(name), period(param(params, 0, 0)), duty(param(params, 1, 0.5)),
+  phase(param(params, 2, 0)), n(0) {
+  if(params.empty() || params.size() > 3)
+    error_exit("Clock has parameters period, duty and phase.");
+  if(period <= 0 || duty <= 0 || duty >= 1 || phase < 0)
+    error_exit("Clock needs period > 0, 0 < duty < 1 and phase >= 0.");
+}
+
+Reset::Reset(const string &name, const vector<Number> &params):
+  Generator(name), level(param(params, 1, 1) != 0), width(param(params, 0, 0)) {
+  if(params.empty() || params.size() > 2 || width <= 0)
+    error_exit("Reset has parameters width > 0 and level.");
+}
+
+Bus::Bus(const string &name, const vector<Number> &params,
+               const char *kind):
+  Generator(name, bus_width(params, kind)), period(param(params, 1, 0)), n(0),
+  width(bus_width(params, kind)) {
+  if(period <= 0)
+    error_exit(string(kind)+" needs 1 <= width <= 64 and period > 0.");
+}
+
+Lfsr::Lfsr(const string &name, const vector<Number> &params):
+  Bus(name, params, "LFSR"), seed(roundl(param(params, 2, 1))), state(0) {
+  if(params.size() < 2 || params.size() > 3 || width < 2 || width > 32)
+    error_exit("LFSR has parameters 2 <= width <= 32, period and seed.");
+  seed &= (1ULL<<width)-1;
+  if(!seed) error_exit("LFSR needs a nonzero seed.");
+}
+
+Random::Random(const string &name, const vector<Number> &params):
+  Bus(name, params, "Random"), seed(roundl(param(params, 2, 1))), state(0) {
+  if(params.size() < 2 || params.size() > 3)
+    error_exit("Random has parameters width, period and seed.");
+  if(!seed) seed = 1; //xorshift needs a nonzero state
+}
@@ -0,0 +1,116 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __GENERATOR_H__
+#define __GENERATOR_H__
+
+#include "main.h"
+#include "source.h"
+
+//procedural inputs declared in the netlist, e.g. clk = clock(1e-8, 0.5, 0);
+//buses drive variables name0, name1, ... (LSB first):
+class Generator: public Source {
+  std::vector<Arg*> args; //driven inputs (NULL if not used)
+  std::vector<std::string> names;
+  std::vector<char> vals; //applied values
+protected:
+  Number t0; //starting simulation time
+  void apply(size_t i, bool val) { //drive the i-th input on change
+    if(vals[i] != val && args[i]) set(args[i], val);
+    vals[i] = val;
+  }
+  void apply(unsigned long long vec) { //drive the whole bus
+    for(size_t i = 0, size = vals.size(); i < size; ++i) apply(i, vec>>i&1);
+  }
+  virtual void start() = 0; //set initial values and the first change
+public:
+  static void create(const std::string &, const std::string &,
+                     const std::vector<Number> &);
+  Generator(const std::string &, size_t = 0);
+  void bind();
+};
+
+class Clock: public Generator { //clock(period, duty = 0.5, phase = 0)
+  Number period, duty, phase;
+  size_t n; //the number of fired edges
+  Number edge() const { //time of the n-th edge (rising edges are even)
+    return t0+phase+(n/2)*period+(n%2)*duty*period;
+  }
+  void start() {n = 0; apply(0, false); tn = edge();}
+public:
+  Clock(const std::string &, const std::vector<Number> &);
+  void fire() {apply(0, n%2 == 0); ++n; tn = edge();}
+};
+
+class Reset: public Generator { //reset(width, level = 1)
+  bool level;
+  Number width;
+  void start() {apply(0, level); tn = t0+width;}
+public:
+  Reset(const std::string &, const std::vector<Number> &);
+  void fire() {apply(0, !level); tn = INFINITY;}
+};
+
+class Bus: public Generator { //a new bus vector in each period
+  Number period;
+  size_t n; //the number of vectors
+  void start() {n = 0; reset(); apply(value()); tn = t0+period;}
+protected:
+  size_t width;
+  virtual void next() = 0;
+  virtual void reset() = 0;
+  virtual unsigned long long value() const = 0;
+public:
+  Bus(const std::string &, const std::vector<Number> &, const char *);
+  void fire() {next(); apply(value()); ++n; tn = t0+(n+1)*period;}
+};
+
+class Counter: public Bus { //counter(width, period)
+  unsigned long long cnt;
+  void next() {++cnt;}
+  void reset() {cnt = 0;}
+  unsigned long long value() const {return cnt;}
+public:
+  Counter(const std::string &name, const std::vector<Number> &params):
+    Bus(name, params, "counter") {}
+};
+
+class Lfsr: public Bus { //lfsr(width, period, seed = 1), Galois form
+  static const unsigned long long masks[]; //feedback of maximal length
+  unsigned long long seed, state;
+  void next() {state = state>>1 ^ (state&1? masks[width]: 0);}
+  void reset() {state = seed;}
+  unsigned long long value() const {return state;}
+public:
+  Lfsr(const std::string &, const std::vector<Number> &);
+};
+
+class Random: public Bus { //random(width, period, seed = 1), xorshift64*
+  unsigned long long seed, state;
+  void next() {state ^= state>>12; state ^= state<<25; state ^= state>>27;}
+  void reset() {state = seed; next();}
+  unsigned long long value() const {
+    return state*0x2545F4914F6CDD1DULL>>(64-width); //the best bits
+  }
+public:
+  Random(const std::string &, const std::vector<Number> &);
+};
+
+#endif
@@ -22,12 +22,15 @@
 #define __MAIN_H__
 
 #include "defaults.h"
+#include "tagged.h"
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
 #include <deque>
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <set>
 #include <sstream>
 #include <vector>
 
@@ -39,46 +42,73 @@ class Event;
 class Expr;
 class Gate;
 class Group;
+struct Load;
+class Measure;
+class Monitor;
+class Network;
 class Sum;
 class Symbols;
 class Term;
 
-struct Arg {
+struct Arg: Tagged<Memory::NETS> {
   const Number *N; //current voltage
   Number Gn, Gp; //conductiv. for n- and p-channel based on logical value of *N
-  Arg(): N(NULL) {}
+  ConditionCh *driver; //sets Gn and Gp of the gate output
+  Gate *gate; //drives the net
+  std::vector<Arg*> fanout; //outputs of the gates driven by this net
+  Monitor *monitor; //timing measurements of the net
+  signed char fn, fp; //channels forced by a fault (1 ~ on, 0 ~ off, -1 ~ free)
+  Arg(): N(NULL), driver(NULL), gate(NULL), monitor(NULL), fn(-1), fp(-1) {}
+  inline void force();
+  inline void wake() const;
 };
 
 enum Type {
-  VAR, ARGS, BITS, NAND, NOR, NOT, XOR
+  VAR, ARGS, BITS, NAND, NOR, NOT, XOR, XNOR, AOI, OAI, MUX, GROUP
 };
 
-extern bool bDebug, bThreaded;
+//generated Taylor step of a gate (wires, settled, charge; see Codegen):
+typedef size_t (*Kernel)(Number *const *, bool *, Number *);
+
+extern bool bDebug, bDedup, bFused, bMixed, bNative, bOptimize, bOutput, bPower,
+  bPredict, bStream, bThreaded;
 extern std::deque<Event> events;
 extern std::deque<Group*> groups;
-extern Group *curGroup;
+extern __thread Group *curGroup; //cur* variables are set per thread
 extern std::map<const void*,std::string> pointers; //for logging
-extern Number dt, mult, t, tmax, Cinv, EPS, Gi, Gclosed, Gopen, U, ONE;
-extern size_t TEST, nThreads, MAXORD, maxSize, maxInputs;
+extern Number dt, mult, t, tmax, Cinv, EPS, Gi, Gclosed, Gopen, U, ONE, SETTLE,
+  REST, STILL, SLEW, GRID, tBegin, tInputs;
+extern size_t TEST, nThreads, MAXORD, maxSize, maxInputs, curStep, curMult,
+  nHot, nSkipped;
 extern std::string show;
 extern Symbols decimals, symbols;
-extern std::vector<Assignment*> *cur_assignments;
-extern std::vector<Condition*> *cur_changed;
-extern std::vector<ConditionCh*> *cur_conditions;
-extern std::vector<Dae*> *cur_daes;
-extern std::vector<std::vector<Number> > *cur_mults;
+extern __thread std::vector<Assignment*> *cur_assignments;
+extern __thread std::vector<Condition*> *cur_changed;
+extern __thread std::vector<ConditionCh*> *cur_conditions;
+extern __thread std::vector<Dae*> *cur_daes;
+extern __thread std::deque<Event> *cur_events;
+extern __thread std::deque<Group*> *cur_groups;
+extern std::vector<std::vector<Number> > *cur_mults, shared_mults;
 extern std::vector<Number> coeff;
 
 #define ABS fabsl
 
 void assign(std::vector<Assignment*> *);
 void error_exit(const std::string &);
-void eval_conditions(std::vector<ConditionCh*> *, std::vector<Condition*> *);
+std::string hr(Number);
 void init_mults(std::vector<std::vector<Number> > &);
 void init_threads();
+bool logic(Type, const std::vector<size_t> &, const std::vector<bool> &);
 void mark_mem_sz();
+Number microtime();
+std::map<const Arg*,std::string> net_names();
+void notify(Monitor *);
 void perform_conditions();
+size_t predict(std::vector<std::vector<Number> > &, Gate *);
 void preinit_threads();
+void set_const(const std::string &, const std::string &);
+bool shown(const std::string &);
+size_t solve_fused(std::vector<std::vector<Number> > &, Gate *);
 size_t taylor(std::vector<std::vector<Number> > &, Gate *);
 
 inline Arg *NULL_PTR() { //to detect cycles
@@ -110,10 +140,31 @@ template<typename F, typename T> inline void sum(const F &from, T &to) {
   to = **it; while(++it != end) to += **it;
 }
 
+//binary state of checkpoints:
+template<typename T> inline void put(FILE *file, const T &val) {
+  fwrite(&val, sizeof(T), 1, file);
+}
+
+template<typename T> inline void get(FILE *file, T &val) {
+  if(fread(&val, sizeof(T), 1, file) != 1) error_exit("Truncated checkpoint.");
+}
+
+#include "checkpoint.h"
+#include "codegen.h"
 #include "control.h"
+#include "counters.h"
 #include "dae.h"
 #include "expr.h"
+#include "fault.h"
+#include "generator.h"
+#include "measure.h"
+#include "network.h"
+#include "profile.h"
+#include "record.h"
 #include "solver.h"
+#include "source.h"
+#include "stimulus.h"
+#include "sweep.h"
 #include "symbols.h"
 #include "term.h"
 #include "threads.h"
@@ -0,0 +1,138 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "measure.h"
+using namespace std;
+
+map<string,Monitor*> Measure::monitors;
+vector<Measure*> Measure::measures;
+vector<Monitor*> Measure::outputs;
+
+void notify(Monitor *monitor) { //the input has changed
+  monitor->input();
+}
+
+void Stat::print(const string &name) const {
+  cerr << n << " " << name;
+  if(n) cerr << " (min " << min << ", mean " << sum/n << ", max " << max << ")";
+}
+
+Monitor::Monitor(Arg *arg): arg(arg), driver(arg->driver), tLow(NAN),
+  tHigh(NAN) {
+  prev = arg->N? *arg->N: 0;
+  val = driver? logic_cast(prev): arg->Gn==Gopen;
+  if(driver) driver->probe(); //polynomials locate crossings
+}
+
+Number Monitor::locate(ConstNumber level) const { //bisection of the step
+  Number a = 0, b = 1, fa = prev-level;
+  for(size_t i = 0; i < DEFAULT_BISECT; ++i) {
+    Number x = (a+b)/2, fx = driver->value(x)-level;
+    if((fx < 0) == (fa < 0)) a = x, fa = fx;
+    else b = x;
+  }
+  return t+(a+b)/2*dt;
+}
+
+void Monitor::transition(ConstNumber tn) {
+  vector<Measure*>::const_iterator it, end = triggers.end();
+  for(it = triggers.begin(); it != end; ++it) (*it)->triggered(tn);
+  for(it = targets.begin(), end = targets.end(); it != end; ++it)
+    (*it)->reached(tn);
+}
+
+void Monitor::input() { //events and sources switch inputs at t
+  bool tmp = arg->Gn==Gopen;
+  if(driver || tmp == val) return;
+  val = tmp;
+  transition(t);
+}
+
+void Monitor::step() {
+  ConstNumber cur = *arg->N, low = -U*DEFAULT_MEASURE_LOW,
+    high = -U*DEFAULT_MEASURE_HIGH;
+  if(prev < low && cur >= low) tLow = locate(low); //rising edge
+  if(prev < high && cur >= high) {
+    if(!isnanl(tLow)) rise.add(locate(high)-tLow);
+    tLow = tHigh = NAN; //a falling edge starts above high again
+  }
+  if(prev > high && cur <= high) tHigh = locate(high); //falling edge
+  if(prev > low && cur <= low) {
+    if(!isnanl(tHigh)) fall.add(locate(low)-tHigh);
+    tHigh = tLow = NAN; //e.g. a glitch that did not reach high
+  }
+  if(logic_cast(cur) != val) {
+    val = !val;
+    ConstNumber tn = driver->crossed(); //unless the condition missed the step
+    transition(tn >= t && tn <= t+dt? tn: locate(ONE));
+  }
+  prev = cur;
+}
+
+Monitor *Measure::monitor(const string &name) { //one monitor for each net
+  Monitor *&monitor = monitors[name];
+  if(!monitor) {
+    map<string,Arg*,num_greater>::const_iterator it = Expr::numbers.find(name);
+    if(it == Expr::numbers.end())
+      error_exit("Measured net \""+name+"\" does not exist.");
+    it->second->monitor = monitor = new Monitor(it->second);
+    if(monitor->driver) outputs.push_back(monitor);
+  }
+  return monitor;
+}
+
+void Measure::init(bool bRestored) { //bind nets after initial conditions
+  if(bRestored && !measures.empty()) { //monitors are not in checkpoints
+    cerr << "Warning: Measurements are off after a restored checkpoint."
+         << endl;
+    measures.clear();
+  }
+  vector<Measure*>::const_iterator it, end = measures.end();
+  for(it = measures.begin(); it != end; ++it) {
+    Measure *measure = *it;
+    monitor(measure->trigger)->triggers.push_back(measure);
+    Monitor *target = monitor(measure->target);
+    if(!target->driver)
+      error_exit("Measured target \""+measure->target+"\" is not a gate.");
+    target->targets.push_back(measure);
+  }
+}
+
+bool Measure::measured(const string &name) { //kept by the optimization
+  vector<Measure*>::const_iterator it, end = measures.end();
+  for(it = measures.begin(); it != end; ++it)
+    if((*it)->trigger == name || (*it)->target == name) return true;
+  return false;
+}
+
+void Measure::report() {
+  vector<Measure*>::const_iterator it, end = measures.end();
+  for(it = measures.begin(); it != end; ++it) {
+    const Measure *measure = *it;
+    const Monitor *target = monitors[measure->target];
+    cerr << "Measure " << measure->trigger << " -> " << measure->target << ": ";
+    measure->delay.print("delays");
+    cerr << ", ";
+    target->rise.print("rises");
+    cerr << ", ";
+    target->fall.print("falls");
+    cerr << ", " << measure->nGlitches << " glitches" << endl;
+  }
+}
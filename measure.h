@@ -0,0 +1,77 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __MEASURE_H__
+#define __MEASURE_H__
+
+#include "main.h"
+#include "stat.h"
+
+//crossings of one measured net; outputs of gates are checked after each step
+//and their crossings are located by the Taylor polynomials of the step (ONE
+//by the condition driving the net), inputs change at the time of their events:
+class Monitor {
+  const Arg *arg;
+  ConditionCh *driver; //NULL for inputs
+  Number prev, tLow, tHigh; //value before the step, crossings of 10 % and 90 %
+  bool val; //logic value
+  Stat rise, fall;
+  std::vector<Measure*> triggers, targets; //measures using the net
+  Number locate(ConstNumber) const;
+  void transition(ConstNumber);
+  friend class Measure;
+public:
+  Monitor(Arg *);
+  void input();
+  void step();
+};
+
+class Measure { //propagation from the trigger to the target, e.g. measure(a, z)
+  static std::map<std::string,Monitor*> monitors;
+  static std::vector<Measure*> measures;
+  static std::vector<Monitor*> outputs; //monitors of gate outputs
+  std::string trigger, target;
+  Number tTrigger; //the last transition of the trigger
+  size_t nTargets, nGlitches; //target transitions since the trigger's one
+  Stat delay;
+  static Monitor *monitor(const std::string &);
+public:
+  static void add(const std::string &trigger, const std::string &target) {
+    measures.push_back(new Measure(trigger, target));
+  }
+  static void init(bool);
+  static bool measured(const std::string &);
+  static void report();
+  static void step() { //crossings in the step starting at t
+    std::vector<Monitor*>::const_iterator it, end = outputs.end();
+    for(it = outputs.begin(); it != end; ++it) (*it)->step();
+  }
+  Measure(const std::string &trigger, const std::string &target):
+    trigger(trigger), target(target), tTrigger(NAN), nTargets(0),
+    nGlitches(0) {}
+  void triggered(ConstNumber tn) {tTrigger = tn; nTargets = 0;}
+  void reached(ConstNumber tn) { //more transitions of the target are glitches
+    if(isnanl(tTrigger)) return;
+    if(nTargets++) ++nGlitches;
+    else delay.add(tn-tTrigger);
+  }
+};
+
+#endif
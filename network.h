@@ -0,0 +1,114 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __NETWORK_H__
+#define __NETWORK_H__
+
+#include "main.h"
+
+//series-parallel network of transistors merged into one conductivity;
+//a transistor is driven by Gn of its argument, or by Gp if the argument is
+//negated (Gp of x behaves as Gn of not(x)):
+class Network: public Tagged<Memory::NETWORKS> {
+  enum Op {LEAF, SER, PAR};
+  struct Node {
+    Op op;
+    Arg *arg; //LEAF
+    bool neg; //LEAF
+    size_t n; //SER, PAR: number of operands
+    Node(Op op, size_t n, Arg *arg = NULL, bool neg = false): op(op), arg(arg),
+      neg(neg), n(n) {}
+    const Number *G() const {return neg? &arg->Gp: &arg->Gn;}
+  };
+  std::vector<Node> nodes; //postfix notation
+  std::vector<const Number*> leaves; //conductivities of LEAF nodes
+  mutable std::vector<Number> stack;
+  friend class Wires; //generated code
+public:
+  Network *dual() const { //the complementary network (e.g. pull-up for NAND)
+    Network *net = new Network;
+    std::vector<Node>::const_iterator it, end = nodes.end();
+    for(it = nodes.begin(); it != end; ++it)
+      switch(it->op) {
+        case LEAF: net->leaf(it->arg, !it->neg); break;
+        case SER: net->par(it->n); break;
+        case PAR: net->ser(it->n); break;
+      }
+    return net;
+  }
+  Number eval() const { //merged conductivity (G is negative, see Chapter 5.4)
+    std::vector<const Number*>::const_iterator leaf = leaves.begin();
+    std::vector<Node>::const_iterator it, end = nodes.end();
+    Number *top = &stack.front();
+    for(it = nodes.begin(); it != end; ++it)
+      if(it->op == LEAF) *top++ = **leaf++;
+      else { //reduce n operands:
+        size_t n = it->n;
+        if(it->op == PAR) { //conductivities are summed
+          Number G = *--top;
+          while(--n) G += *--top;
+          *top++ = G;
+        }
+        else { //resistances are summed
+          Number R = 1 / *--top;
+          while(--n) R += 1 / *--top;
+          *top++ = 1/R;
+        }
+      }
+    return stack.front();
+  }
+  void leaf(Arg *arg, bool neg) {
+    nodes.push_back(Node(LEAF, 0, arg, neg));
+    leaves.push_back(nodes.back().G());
+    stack.push_back(0);
+  }
+  void par(size_t n) {if(n > 1) nodes.push_back(Node(PAR, n));}
+  void ser(size_t n) {if(n > 1) nodes.push_back(Node(SER, n));}
+  size_t heap() const { //bytes of its containers
+    return Memory::heap(nodes)+Memory::heap(leaves)+Memory::heap(stack);
+  }
+  const std::vector<const Number*> &inputs() const {return leaves;}
+  void shape(std::vector<size_t> &key) const { //equal for equal networks
+    std::vector<Node>::const_iterator it, end = nodes.end();
+    for(it = nodes.begin(); it != end; ++it) {
+      key.push_back(it->op);
+      key.push_back(it->op == LEAF? it->neg: it->n);
+    }
+  }
+  size_t size() const {return leaves.size();} //number of transistors
+  size_t width() const { //number of parallel paths (merged capacitors)
+    std::vector<size_t> widths;
+    std::vector<Node>::const_iterator it, end = nodes.end();
+    for(it = nodes.begin(); it != end; ++it)
+      if(it->op == LEAF) widths.push_back(1);
+      else {
+        size_t w = 0;
+        for(size_t i = 0; i < it->n; ++i) { //PAR sums and SER takes maximum
+          size_t w2 = widths.back();
+          widths.pop_back();
+          w = it->op==PAR? w+w2: std::max(w, w2);
+        }
+        widths.push_back(w);
+      }
+    return widths.empty()? 1: widths.back();
+  }
+};
+
+#endif
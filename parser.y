@@ -36,11 +36,14 @@ void set_par(const string &, const string &); //set non-number const
 %union {
   unsigned int id;
   class Expr *node;
+  std::vector<Number> *nums;
 }
 
-%token <id> LEX_AND LEX_BEGIN LEX_BIT LEX_COMMA LEX_DECIMAL LEX_END LEX_EQUALS
-            LEX_ID LEX_LEFT LEX_RIGHT LEX_SETUP LEX_NAND LEX_NOR LEX_NOT LEX_XOR
+%token <id> LEX_AND LEX_AOI LEX_BEGIN LEX_BIT LEX_COMMA LEX_DECIMAL LEX_END
+            LEX_EQUALS LEX_ID LEX_LEFT LEX_MEASURE LEX_MUX LEX_NAND LEX_NOR
+            LEX_NOT LEX_OAI LEX_RIGHT LEX_SETUP LEX_STRING LEX_XNOR LEX_XOR
 %type <node> arg args bits expr gate input iv setup setupLine setupLines source
+%type <nums> nums
 
 %%
 
@@ -56,15 +59,28 @@ setupLines: setupLines setupLine
 setupLine: LEX_ID LEX_EQUALS LEX_BIT {set_const(symbols[$1], $3? "1": "0");}
          | LEX_ID LEX_EQUALS LEX_DECIMAL {set_const(symbols[$1], decimals[$3]);}
          | LEX_ID LEX_EQUALS LEX_ID {set_par(symbols[$1], symbols[$3]);}
+         | LEX_ID LEX_EQUALS LEX_STRING {set_par(symbols[$1], symbols[$3]);}
 
-input: input expr
-      | expr
+input: input expr {Expr::statement();}
+      | expr {Expr::statement();}
 
 //e.g. x = 1, 1, 0
 expr: LEX_ID LEX_EQUALS LEX_ID {new Expr(symbols[$1], symbols[$3]);}
     | LEX_ID LEX_EQUALS bits {$3->set_var(symbols[$1]);}
     | LEX_ID LEX_EQUALS gate {$3->set_var(symbols[$1]);}
+    | LEX_ID LEX_EQUALS LEX_ID LEX_LEFT nums LEX_RIGHT
+      {Generator::create(symbols[$1], symbols[$3], *$5); delete $5;}
     | gate
+    | LEX_MEASURE LEX_LEFT LEX_ID LEX_COMMA LEX_ID LEX_RIGHT
+      {Measure::add(symbols[$3], symbols[$5]);} //delays from $3 to $5
+
+//generator parameters, e.g. clk = clock(1e-8, 0.5)
+nums: nums LEX_COMMA LEX_DECIMAL
+      {$$ = $1; $$->push_back(str2num(decimals[$3].c_str()));}
+    | nums LEX_COMMA LEX_BIT {$$ = $1; $$->push_back($3);}
+    | LEX_DECIMAL
+      {$$ = new std::vector<Number>(1, str2num(decimals[$1].c_str()));}
+    | LEX_BIT {$$ = new std::vector<Number>(1, $1);}
 
 bits: bits LEX_COMMA LEX_BIT {$$ = $1; $$->add($3);}
     | LEX_BIT {$$ = new Expr($1);}
@@ -74,6 +90,10 @@ gate: LEX_NAND LEX_LEFT args iv {$$ = $3; $$->set_type(NAND); $$->set_iv($4);}
     | LEX_NOR LEX_LEFT args iv {$$ = $3; $$->set_type(NOR); $$->set_iv($4);}
     | LEX_NOT LEX_LEFT args iv {$$ = $3; $$->set_type(NOT); $$->set_iv($4);}
     | LEX_XOR LEX_LEFT args iv {$$ = $3; $$->set_type(XOR); $$->set_iv($4);}
+    | LEX_XNOR LEX_LEFT args iv {$$ = $3; $$->set_type(XNOR); $$->set_iv($4);}
+    | LEX_AOI LEX_LEFT args iv {$$ = $3; $$->set_type(AOI); $$->set_iv($4);}
+    | LEX_OAI LEX_LEFT args iv {$$ = $3; $$->set_type(OAI); $$->set_iv($4);}
+    | LEX_MUX LEX_LEFT args iv {$$ = $3; $$->set_type(MUX); $$->set_iv($4);}
 
 iv: LEX_AND LEX_BIT LEX_RIGHT {$$ = new Expr($2);} //initial value
   | LEX_RIGHT {$$ = new Expr(~0U);} //without initial value
@@ -81,8 +101,10 @@ iv: LEX_AND LEX_BIT LEX_RIGHT {$$ = new Expr($2);} //initial value
 args: args LEX_COMMA arg {$$ = $1; $$->add($3);}
     | arg {$$ = new Expr($1);}
 
+//e.g. aoi((a, b), c) ~ not(a and b or c), oai((a, b), c) ~ not((a or b) and c)
 arg: LEX_ID {$$ = new Expr(symbols[$1]);}
    | gate {$$ = $1;}
+   | LEX_LEFT args LEX_RIGHT {$$ = $2; $$->set_type(GROUP);}
 
 %%
 
@@ -136,6 +158,17 @@ void set_const(const string &name, const string &value) { //set number const
   else if(lc == "rclosed") Gclosed = -1/val; //resistance of closed channel
   else if(lc == "dt") dt = val; //step size
   else if(lc == "eps") EPS = val; //precision
+  else if(lc == "settle") SETTLE = val; //skip steps with smaller changes
+  else if(lc == "rest") REST = val; //gates with smaller changes rest if mixed
+  else if(lc == "grid") GRID = val; //output step evaluated from polynomials
+  else if(lc == "variants") Sweep::set_variants(roundl(val)); //Monte Carlo
+  else if(lc == "sigma") Sweep::set_sigma(val); //rel. deviation of ri of gates
+  else if(lc == "seed") Sweep::set_seed(roundl(val)); //of the variation
+  else if(lc == "every") Checkpoint::set_every(roundl(val)); //checkpoint steps
+  else if(lc == "power") { //energy of gates, report the given number of them
+    nHot = val > 0? roundl(val): 0;
+    bPower = val > 0; //0 ~ off
+  }
   else if(lc == "test") TEST = roundl(val); //nr. of tested Taylor polynomials
   else if(lc == "tmin") t = val; //starting simulation time
   else cerr << "Warning: Unknown parameter \"" << name << "\"." << endl;
@@ -154,5 +187,24 @@ void set_par(const string &name, const string &value) { //set non-number const
   //show variables with prefix value otherwise
   if(lc == "show") show = value;
   else if(lc == "debug") bDebug = get_bool(value);
+  else if(lc == "stream") bStream = get_bool(value); //lower statements early
+  else if(lc == "optimize") bOptimize = get_bool(value); //logic optimization
+  else if(lc == "output") bOutput = get_bool(value); //print waveforms
+  else if(lc == "counters") Counters::enable(get_bool(value)); //perf events
+  else if(lc == "memory") Memory::set_file(value); //e.g. "mem.tsv"
+  else if(lc == "mixed") bMixed = get_bool(value); //settled gates as logic
+  else if(lc == "predict") bPredict = get_bool(value); //orders of gates
+  else if(lc == "fused") bFused = get_bool(value); //NAND, NOR and NOT
+  else if(lc == "dedup") bDedup = get_bool(value); //equal gates share steps
+  else if(lc == "native") bNative = get_bool(value); //XOR as a compound gate
+  else if(lc == "stimulus") Source::add(new Stimulus(value)); //e.g. "in.txt"
+  else if(lc == "sweep") Sweep::add(value); //e.g. "ropen 0.5 0.6 0.7"
+  else if(lc == "faults") Fault::load(value); //e.g. "faults.txt"
+  else if(lc == "checkpoint") Checkpoint::set_file(value); //e.g. "run.chk"
+  else if(lc == "record") Record::set_dir(value); //incremental re-simulation
+  else if(lc == "codegen") Codegen::set_dir(value); //cache of kernels
+  else if(lc == "restore") Checkpoint::set_restore(value); //start from it
+  else if(lc == "profile") Profile::set_file(value); //e.g. "run.json"
+  else if(lc == "prefix") Sweep::set_prefix(value); //files of the variants
   else cerr << "Warning: Unknown parameter \"" << name << "\"." << endl;
 }
@@ -0,0 +1,142 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "profile.h"
+using namespace std;
+
+bool Profile::bEnabled = false;
+string Profile::file;
+Number Profile::times[PHASES], Profile::tLast = microtime();
+Profile::Phase Profile::cur = PARSE;
+vector<Load*> Profile::loads;
+Stat Profile::idle;
+
+static const char *phases[] = {"parse", "elaborate", "init", "inputs", "solve",
+  "conditions", "output"};
+
+void Profile::init() { //after the groups are created
+  if(!bEnabled) return;
+  deque<Group*>::const_iterator it, end = groups.end();
+  for(it = groups.begin(); it != end; ++it) {
+    loads.push_back(new Load);
+    (*it)->profile(loads.back());
+  }
+}
+
+//gates with the highest orders:
+static vector<pair<size_t,const Gate*> > top() {
+  vector<pair<size_t,const Gate*> > gates;
+  deque<Group*>::const_iterator it, end = groups.end();
+  for(it = groups.begin(); it != end; ++it) {
+    vector<Gate*>::const_iterator gate, gend = (*it)->end();
+    for(gate = (*it)->begin(); gate != gend; ++gate)
+      gates.push_back(make_pair((*gate)->order(), *gate));
+  }
+  size_t size = min<size_t>(DEFAULT_PROFILE_TOP, gates.size());
+  partial_sort(gates.begin(), gates.begin()+size, gates.end(),
+    greater<pair<size_t,const Gate*> >());
+  gates.resize(size);
+  return gates;
+}
+
+static string name(const map<const Arg*,string> &names, const Gate *gate) {
+  map<const Arg*,string>::const_iterator it = names.find(gate->output());
+  return it == names.end()? pointer(gate): it->second;
+}
+
+static vector<size_t> histogram(const vector<Load*> &loads) {
+  vector<size_t> orders;
+  vector<Load*>::const_iterator it, end = loads.end();
+  for(it = loads.begin(); it != end; ++it) {
+    const vector<size_t> &cur = (*it)->orders;
+    if(orders.size() < cur.size()) orders.resize(cur.size());
+    for(size_t i = 0; i < cur.size(); ++i) orders[i] += cur[i];
+  }
+  return orders;
+}
+
+void Profile::write_csv(ostream &out) { //section,key,values...
+  for(size_t i = 0; i < PHASES; ++i)
+    out << "phase," << phases[i] << "," << times[i] << endl;
+  for(size_t i = 0; i < loads.size(); ++i) {
+    const Stat &time = loads[i]->time;
+    out << "group," << i+1 << "," << time.count() << ",";
+    if(time.count()) //no minimum, mean and maximum of a group never solved
+      out << time.minimum() << "," << time.total()/time.count() << ","
+          << time.maximum();
+    else out << ",,";
+    out << "," << time.total() << endl;
+  }
+  vector<size_t> orders = histogram(loads);
+  for(size_t i = 1; i < orders.size(); ++i)
+    if(orders[i]) out << "order," << i << "," << orders[i] << endl;
+  map<const Arg*,string> names = net_names();
+  vector<pair<size_t,const Gate*> > gates = top();
+  for(size_t i = 0; i < gates.size(); ++i)
+    out << "gate," << name(names, gates[i].second) << "," << gates[i].first
+        << endl;
+  if(idle.count())
+    out << "idle," << idle.count() << "," << idle.total()/idle.count() << ","
+        << idle.total() << endl;
+}
+
+void Profile::write_json(ostream &out) {
+  out << "{\n  \"phases\": {";
+  for(size_t i = 0; i < PHASES; ++i)
+    out << (i? ", ": "") << "\"" << phases[i] << "\": " << times[i];
+  out << "},\n  \"groups\": [";
+  for(size_t i = 0; i < loads.size(); ++i) {
+    const Stat &time = loads[i]->time;
+    out << (i? ",": "") << "\n    {\"steps\": " << time.count();
+    if(time.count()) //no minimum, mean and maximum of a group never solved
+      out << ", \"min\": " << time.minimum() << ", \"mean\": "
+          << time.total()/time.count() << ", \"max\": " << time.maximum();
+    out << ", \"total\": " << time.total() << "}";
+  }
+  out << "],\n  \"orders\": {";
+  vector<size_t> orders = histogram(loads);
+  bool bFirst = true;
+  for(size_t i = 1; i < orders.size(); ++i)
+    if(orders[i]) {
+      out << (bFirst? "": ", ") << "\"" << i << "\": " << orders[i];
+      bFirst = false;
+    }
+  out << "},\n  \"gates\": [";
+  map<const Arg*,string> names = net_names();
+  vector<pair<size_t,const Gate*> > gates = top();
+  for(size_t i = 0; i < gates.size(); ++i)
+    out << (i? ", ": "") << "{\"name\": \"" << name(names, gates[i].second)
+        << "\", \"order\": " << gates[i].first << "}";
+  out << "]";
+  if(idle.count())
+    out << ",\n  \"idle\": {\"steps\": " << idle.count() << ", \"mean\": "
+        << idle.total()/idle.count() << ", \"total\": " << idle.total() << "}";
+  out << "\n}" << endl;
+}
+
+void Profile::report() {
+  if(!bEnabled) return;
+  phase(cur); //close the current phase
+  ofstream out(file.c_str());
+  if(!out) error_exit("Cannot write profile \""+file+"\".");
+  size_t pos = file.rfind('.');
+  if(pos != string::npos && file.substr(pos) == ".csv") write_csv(out);
+  else write_json(out);
+}
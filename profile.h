@@ -0,0 +1,71 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __PROFILE_H__
+#define __PROFILE_H__
+
+#include "main.h"
+#include "stat.h"
+
+//opt-in instrumentation, e.g. profile = "run.json" (or "run.csv"); the
+//solver phases are timed by switching between them:
+class Profile {
+public:
+  enum Phase {PARSE, ELABORATE, INIT, INPUTS, SOLVE, CONDITIONS, OUTPUT,
+    PHASES};
+private:
+  static bool bEnabled;
+  static std::string file;
+  static Number times[PHASES], tLast;
+  static Phase cur;
+  static std::vector<Load*> loads;
+  static Stat idle; //of the workers in a step
+  static void write_csv(std::ostream &);
+  static void write_json(std::ostream &);
+public:
+  static bool enabled() {return bEnabled;}
+  static void init();
+  static void phase(Phase next) {
+    if(!bEnabled) return;
+    Number now = microtime();
+    times[cur] += now-tLast;
+    tLast = now;
+    cur = next;
+  }
+  static void report();
+  static void set_file(const std::string &name) {
+    file = name;
+    bEnabled = name != "";
+  }
+  static void step(ConstNumber wall) { //idle time of the workers in a step
+    Number busy = 0;
+    std::vector<Load*>::const_iterator it, end = loads.end();
+    for(it = loads.begin(); it != end; ++it) busy += (*it)->last;
+    idle.add(nThreads*wall-busy);
+  }
+  static void suffix(const std::string &str) { //one profile per variant
+    size_t dot = file.rfind('.'), slash = file.rfind('/');
+    if(dot == std::string::npos || (slash != std::string::npos && dot < slash))
+      dot = file.size();
+    if(bEnabled) file.insert(dot, str); //keeps the format (e.g. run.1.csv)
+  }
+};
+
+#endif
@@ -0,0 +1,218 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "record.h"
+#include <sys/stat.h>
+using namespace std;
+
+string Record::dir;
+bool Record::bFull = false;
+Number Record::tSplice = NAN;
+FILE *Record::index = NULL;
+ofstream Record::out;
+streambuf *Record::stdout_buf = NULL;
+
+static string checkpoint(const string &dir, size_t step) {
+  stringstream ss;
+  ss << dir << "/" << step << ".chk";
+  return ss.str();
+}
+
+template<typename T> static void append(string &str, const T &val) {
+  str.append(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+static void append(string &str, ConstNumber num) { //without padding bytes
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%La\n", num);
+  str += buf;
+}
+
+//FNV-1a of the numeric setup and of the gates with their wiring (unnamed
+//nets are numbered in the order of their first use):
+static unsigned long long fingerprint() {
+  string str;
+  Number nums[] = {Cinv, Gi, Gopen, Gclosed, U, ONE, EPS, SETTLE, REST, GRID,
+    mult};
+  for(size_t i = 0; i < sizeof(nums)/sizeof(*nums); ++i) append(str, nums[i]);
+  append(str, TEST);
+  append(str, bMixed);
+  append(str, bPredict);
+  str += show+'\n';
+  map<const Arg*,string> nets = net_names();
+  map<const Number*,string> names;
+  map<const Arg*,string>::const_iterator net, nend = nets.end();
+  for(net = nets.begin(); net != nend; ++net) {
+    names[&net->first->Gn] = net->second+".n";
+    names[&net->first->Gp] = net->second+".p";
+  }
+  map<const Number*,size_t> ids;
+  deque<Group*>::const_iterator it, end = groups.end();
+  for(it = groups.begin(); it != end; ++it) {
+    append(str, (*it)->end()-(*it)->begin());
+    vector<Gate*>::const_iterator gate, gend = (*it)->end();
+    for(gate = (*it)->begin(); gate != gend; ++gate) {
+      vector<size_t> key;
+      (*gate)->shape(key);
+      str.append(reinterpret_cast<const char*>(&key[0]),
+                 key.size()*sizeof(size_t));
+      str += nets[(*gate)->output()]+'\n';
+      const vector<const Number*> &reads = (*gate)->inputs();
+      vector<const Number*>::const_iterator num, rend = reads.end();
+      for(num = reads.begin(); num != rend; ++num) {
+        append(str, **num); //also varied conductivities
+        append(str, ids.insert(make_pair(*num, ids.size())).first->second);
+        str += names[*num]+'\n';
+      }
+    }
+  }
+  unsigned long long h = 14695981039346656037ULL;
+  string::const_iterator c, cend = str.end();
+  for(c = str.begin(); c != cend; ++c)
+    h = (h^(unsigned char)*c)*1099511628211ULL;
+  return h;
+}
+
+//the first time from which the events differ from the recorded ones
+//(NAN if they cannot be compared, INFINITY if they are the same):
+Number Record::differs() {
+  FILE *in = fopen((dir+"/events").c_str(), "rb");
+  if(!in) return NAN;
+  Number step, start, tn;
+  size_t size, len;
+  unsigned long long circuit;
+  bool val;
+  get(in, step);
+  get(in, start);
+  get(in, circuit);
+  get(in, size);
+  if(step != dt || start != t || circuit != fingerprint()) {
+    fclose(in);
+    return NAN;
+  }
+  map<const Arg*,string> nets = net_names();
+  string name;
+  Number tDiff = INFINITY;
+  deque<Event>::const_iterator it = events.begin(), end = events.end();
+  for(size_t i = 0; i < size; ++i, ++it) {
+    get(in, tn);
+    get(in, val);
+    get(in, len);
+    name.resize(len);
+    if(len && fread(&name[0], 1, len, in) != len)
+      error_exit("Truncated record of events.");
+    if(it == end) {
+      tDiff = tn;
+      break;
+    }
+    if(tn != it->time() || val != it->value() || name != nets[it->input()]) {
+      tDiff = min(tn, it->time());
+      break;
+    }
+  }
+  if(it != end && tDiff == INFINITY) tDiff = it->time(); //new events
+  fclose(in);
+  return tDiff;
+}
+
+void Record::save_events() {
+  FILE *file = fopen((dir+"/events").c_str(), "wb");
+  if(!file) error_exit("Cannot write the record \""+dir+"\".");
+  put(file, dt);
+  put(file, t);
+  put(file, fingerprint());
+  put(file, events.size());
+  map<const Arg*,string> nets = net_names();
+  deque<Event>::const_iterator it, end = events.end();
+  for(it = events.begin(); it != end; ++it) {
+    const string &name = nets[it->input()];
+    put(file, it->time());
+    put(file, it->value());
+    put(file, name.size());
+    fwrite(name.data(), 1, name.size(), file);
+  }
+  fclose(file);
+}
+
+void Record::init() { //choose the checkpoint before the first difference
+  if(dir == "") return;
+  mkdir(dir.c_str(), 0777);
+  Number tDiff = Source::none()? differs(): NAN; //sources cannot be compared
+  if(bOutput && !ifstream((dir+"/output.tsv").c_str())) tDiff = NAN;
+  if(bFull) tDiff = NAN;
+  vector<pair<Number,size_t> > kept;
+  if(!isnanl(tDiff)) {
+    FILE *in = fopen((dir+"/index").c_str(), "rb");
+    pair<Number,size_t> entry;
+    if(in) {
+      while(fread(&entry.first, sizeof(Number), 1, in) == 1 &&
+            fread(&entry.second, sizeof(size_t), 1, in) == 1 &&
+            entry.first <= tDiff && entry.first <= tmax)
+        kept.push_back(entry);
+      fclose(in);
+    }
+  }
+  save_events();
+  if(!(index = fopen((dir+"/index").c_str(), "wb")))
+    error_exit("Cannot write the record \""+dir+"\".");
+  vector<pair<Number,size_t> >::const_iterator it, end = kept.end();
+  for(it = kept.begin(); it != end; ++it) {
+    put(index, it->first);
+    put(index, it->second);
+  }
+  fflush(index);
+  if(!kept.empty()) {
+    tSplice = kept.back().first;
+    Checkpoint::set_restore(checkpoint(dir, kept.back().second));
+  }
+  if(bOutput) { //the new output replaces the old one at the end
+    out.open((dir+"/output.tmp").c_str());
+    stdout_buf = cout.rdbuf(new Tee(cout.rdbuf(), out.rdbuf()));
+  }
+}
+
+void Record::splice() { //rows of the previous run before the checkpoint
+  if(isnanl(tSplice) || !bOutput) return;
+  ifstream in((dir+"/output.tsv").c_str());
+  string line;
+  getline(in, line); //header
+  Number tEnd = GRID > 0? tSplice+dt/2: tSplice-dt/2; //dense rows up to t
+  while(getline(in, line) && str2num(line.c_str()) < tEnd) //or printed t
+    cout << line << '\n';
+}
+
+void Record::save() {
+  Checkpoint::write(checkpoint(dir, curStep));
+  put(index, t);
+  put(index, curStep);
+  fflush(index);
+}
+
+void Record::finish() {
+  if(dir == "") return;
+  fclose(index);
+  index = NULL;
+  if(!stdout_buf) return;
+  cout.flush();
+  delete cout.rdbuf(stdout_buf);
+  out.close();
+  if(rename((dir+"/output.tmp").c_str(), (dir+"/output.tsv").c_str()))
+    error_exit("Cannot write the record \""+dir+"\".");
+}
@@ -0,0 +1,80 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __RECORD_H__
+#define __RECORD_H__
+
+#include "main.h"
+
+class Tee: public std::streambuf { //copies the output into the record
+  std::streambuf *a, *b;
+  char buffer[DEFAULT_STIMULUS_BUF];
+  void flush() {
+    std::streamsize n = pptr()-pbase();
+    a->sputn(pbase(), n);
+    b->sputn(pbase(), n);
+    setp(buffer, buffer+sizeof(buffer));
+  }
+protected:
+  int overflow(int c) {
+    flush();
+    if(c != EOF) sputc(c);
+    return c == EOF? 0: c;
+  }
+  int sync() {
+    flush();
+    return a->pubsync() | b->pubsync();
+  }
+public:
+  Tee(std::streambuf *a, std::streambuf *b): a(a), b(b) {
+    setp(buffer, buffer+sizeof(buffer));
+  }
+};
+
+//incremental re-simulation, e.g. record = "run": the directory keeps the
+//events, the output and checkpoints of the last run; if only events after
+//some time differ (and the circuit with its setup are the same, see
+//fingerprint), the run restores the last checkpoint before the first
+//difference and the output before it is copied from the previous run;
+//variant k of a sweep uses dir.k, faulty copies record nothing and the good
+//machine always runs in full (the copies compare all of its steps):
+class Record {
+  static std::string dir;
+  static bool bFull; //never restore
+  static Number tSplice; //time of the restored checkpoint (NAN ~ full run)
+  static FILE *index; //times and steps of the checkpoints
+  static std::ofstream out;
+  static std::streambuf *stdout_buf;
+  static Number differs();
+  static void save();
+  static void save_events();
+public:
+  static void finish();
+  static void init();
+  static void full() {bFull = true;}
+  static void set_dir(const std::string &name) {dir = name;}
+  static void splice();
+  static void suffix(const std::string &str) {if(dir != "") dir += str;}
+  static void step() { //after the step
+    if(index && !(curStep%DEFAULT_RECORD)) save();
+  }
+};
+
+#endif
@@ -23,29 +23,41 @@
 #include <unistd.h>
 using namespace std;
 
-bool bDebug = false, bMult = false, bSuf = false, bThreaded = false;
+bool bDebug = false, bDedup = false, bFused = true, bMixed = false,
+  bMult = false, bNative = false, bOptimize = false, bOutput = true,
+  bPower = false, bPredict = false, bStream = false, bSuf = false,
+  bThreaded = false;
 deque<Event> events;
+deque<Event>::const_iterator next_event; //the first inactive event
 deque<Group*> groups;
-Group *curGroup = NULL;
+__thread Group *curGroup = NULL;
 vector<const Number*> numbers;
+vector<const ConditionCh*> probes; //polynomials of numbers for dense output
 map<const void*,string> pointers;
 Number Cinv = 1.L/DEFAULT_C, Gi = -1.L/DEFAULT_RI, Gopen = -1.L/DEFAULT_ROPEN,
   Gclosed = -1.L/DEFAULT_RCLOSED, U = -DEFAULT_U, ONE = nanl(""),
   dt = DEFAULT_DT, mult = 0, t = DEFAULT_TMIN, tmax = DEFAULT_TMAX,
-  EPS = DEFAULT_EPS, t0 = 0, totalMem = 0;
+  EPS = DEFAULT_EPS, SETTLE = 0, REST = 0, STILL = 0, SLEW = 0, GRID = 0,
+  t0 = 0, tBegin = 0, tInputs = -INFINITY, totalMem = 0;
 size_t TEST = DEFAULT_TEST, MAXORD = 0, nThreads = DEFAULT_THREADS,
-  maxSize = DEFAULT_BUNCH, maxInputs = 0, curMult = 0, nMult = 0;
+  maxSize = DEFAULT_BUNCH, maxInputs = 0, curMult = 0, nMult = 0, nSkipped = 0,
+  curStep = 0, nGrid = 0, nHot = 0;
 string show;
 Threads threads;
-vector<Assignment*> *cur_assignments = NULL;
-vector<Condition*> *cur_changed = NULL;
-vector<ConditionCh*> *cur_conditions = NULL;
-vector<Dae*> *cur_daes = NULL;
+__thread vector<Assignment*> *cur_assignments = NULL;
+__thread vector<Condition*> *cur_changed = NULL;
+__thread vector<ConditionCh*> *cur_conditions = NULL;
+__thread vector<Dae*> *cur_daes = NULL;
+__thread deque<Event> *cur_events = &events;
+__thread deque<Group*> *cur_groups = &groups;
 vector<vector<Number> > *cur_mults = NULL;
+vector<vector<Number> > shared_mults; //immutable (inputs x DEFAULT_ORDERS)
 vector<Number> coeff;
 vector<size_t> lengths;
 
-size_t Dae::nAlgs = 0, Dae::nODEs = 0;
+__thread size_t Dae::nAlgs = 0, Dae::nODEs = 0;
+vector<Source*> Source::sources;
+Number Source::tNext = INFINITY;
 
 void yylex_destroy();
 int yyparse();
@@ -78,15 +90,19 @@ inline bool sufm(const string &str) { //matches the suffix?
   return str.substr(idx) == show;
 }
 
+bool shown(const string &name) { //should the variable be printed?
+  if(show == "") return true;
+  return show[0]=='_'? sufm(name): prefm(name);
+}
+
 void print_header() {
-  bool bShow = show!="";
   bSuf = show[0]=='_';
   cout << "t";
   map<string,Arg*>::const_iterator it, end = Expr::numbers.end();
   string printed;
   size_t n = 0;
   for(it = Expr::numbers.begin(); it != end; ++it) //if var should be shown:
-    if(it->second->N && (!bShow || (bSuf? sufm(it->first): prefm(it->first)))) {
+    if(it->second->N && shown(it->first)) {
       if(bSuf) { //group variable names by the suffix
         string pref = rmsuf(it->first);
         if(pref != printed) { //if the group of variables not printed yet
@@ -99,6 +115,7 @@ void print_header() {
       }
       else cout << "\t" << it->first;
       numbers.push_back(it->second->N);
+      probes.push_back(it->second->driver); //recorded by init_variant
     }
   lengths.push_back(n);
   cout << endl;
@@ -184,16 +201,16 @@ void print_debug() {
   cerr << endl;
 }
 
-inline void print_results() {
-  if(bMult) {
-    if(++curMult < nMult) return;
-    curMult = 0;
-  }
-  cout << t;
+//print values at time which is at x (0 < x <= 1) of the last step:
+inline void print_row(ConstNumber time, ConstNumber x = 1) {
+  cout << time;
   static vector<const Number*>::const_iterator it, end = numbers.end();
+  static vector<const ConditionCh*>::const_iterator probe;
   static vector<size_t>::const_iterator rep;
   size_t n = 0, repeat = 1;
-  for(it = numbers.begin(), rep = lengths.begin(); it != end; ++it)
+  for(it = numbers.begin(), probe = probes.begin(), rep = lengths.begin();
+      it != end; ++it, ++probe) {
+    ConstNumber val = x < 1 && *probe? (*probe)->value(x): **it;
     if(bSuf) { //print digital values
       if(++n == repeat) {
         repeat = *rep;
@@ -201,12 +218,36 @@ inline void print_results() {
         n = 0;
         cout << "\t";
       }
-      cout << logic_cast(**it);
+      cout << logic_cast(val);
     }
-    else cout << "\t" << **it; //print analog values
+    else cout << "\t" << val; //print analog values
+  }
   cout << endl;
 }
 
+inline Number grid_time() {return tBegin+nGrid*GRID;}
+
+inline void print_dense() { //rows of the output grid within the last step
+  Number tn;
+  while((tn = grid_time()) <= t) {
+    print_row(tn, 1-(t-tn)/dt);
+    ++nGrid;
+  }
+}
+
+inline void print_results() {
+  if(!bOutput) return; //e.g. only measurements
+  if(GRID > 0) {
+    print_dense();
+    return;
+  }
+  if(bMult) {
+    if(++curMult < nMult) return;
+    curMult = 0;
+  }
+  print_row(t);
+}
+
 string hr(Number size) { //return memory usage in human-readable form
   static long pagesize = sysconf(_SC_PAGE_SIZE);
   static char prefix[] = " kMGTPEZY";
@@ -231,6 +272,49 @@ void mark_mem_sz() { //mark memory usage if it increases
   if(size > totalMem) totalMem = size;
 }
 
+bool hotter(const pair<Number,const Gate*> &a,
+            const pair<Number,const Gate*> &b) {
+  return a.first > b.first;
+}
+
+map<const Arg*,string> net_names() { //the first name of each net
+  map<const Arg*,string> names;
+  map<string,Arg*,num_greater>::const_iterator it, end = Expr::numbers.end();
+  for(it = Expr::numbers.begin(); it != end; ++it)
+    if(!names.count(it->second)) names[it->second] = it->first;
+  return names;
+}
+
+void print_power() { //charge and energy drawn from U, the hottest gates
+  map<const Arg*,string> names = net_names();
+  vector<pair<Number,const Gate*> > gates;
+  Number total = 0;
+  size_t i = 0;
+  deque<Group*>::const_iterator it, end = groups.end();
+  for(it = groups.begin(); it != end; ++it) {
+    Number sum = 0;
+    vector<Gate*>::const_iterator gate, gend = (*it)->end();
+    for(gate = (*it)->begin(); gate != gend; ++gate) {
+      sum += (*gate)->charge();
+      gates.push_back(make_pair(ABS((*gate)->charge()*U), *gate));
+    }
+    if(groups.size() > 1)
+      cerr << "Energy of group " << ++i << ": " << ABS(sum*U) << endl;
+    total += sum;
+  }
+  cerr << "Total charge: " << ABS(total) << endl;
+  cerr << "Total energy: " << ABS(total*U) << endl;
+  size_t size = min(nHot, gates.size());
+  partial_sort(gates.begin(), gates.begin()+size, gates.end(), hotter);
+  for(i = 0; i < size; ++i) {
+    map<const Arg*,string>::const_iterator name;
+    name = names.find(gates[i].second->output());
+    cerr << "Hot gate " << i+1 << ": "
+         << (name == names.end()? pointer(gates[i].second): name->second)
+         << " " << gates[i].first << endl;
+  }
+}
+
 void print_stats() {
   mark_mem_sz();
   cerr << "Maximal order: " << MAXORD << endl;
@@ -240,11 +324,29 @@ void print_stats() {
   cerr << "Number of inverters: " << Term::invs() << endl;
   cerr << "Number of NANDs: " << Term::nands() << endl;
   cerr << "Number of NORs: " << Term::nors() << endl;
+  cerr << "Number of compound gates: " << Term::compounds() << endl;
   cerr << "Number of gates: " << Term::gates() << endl;
+  if(bOptimize) cerr << "Removed gates: " << Term::removed() << endl;
+  if(SETTLE > 0) cerr << "Skipped steps: " << nSkipped << endl;
+  if(bMixed) {
+    size_t nLogic = 0;
+    deque<Group*>::const_iterator it, end = groups.end();
+    for(it = groups.begin(); it != end; ++it) nLogic += (*it)->logic();
+    cerr << "Gate steps at logic level: " << nLogic << endl;
+  }
+  if(bDedup) {
+    size_t nShared = 0;
+    deque<Group*>::const_iterator it, end = groups.end();
+    for(it = groups.begin(); it != end; ++it) nShared += (*it)->shared();
+    cerr << "Shared gate steps: " << nShared << endl;
+  }
   cerr << "Number of transistors: " << Term::trans() << endl;
   cerr << "Used memory: " << hr(totalMem) << endl;
+  Memory::report(cerr);
+  Codegen::report();
   cerr << "Clock time: " << (Number)clock()/CLOCKS_PER_SEC << " s" << endl;
   cerr << "Execution time: " << microtime()-t0 << " s" << endl;
+  Counters::report();
 }
 
 void perform_conditions() { //perform the transistor-input changes
@@ -258,17 +360,14 @@ void eval_conditions(vector<ConditionCh*> *all) {
   for(it = all->begin(); it != end; ++it) (*it)->eval();
 }
 
-void eval_conditions(vector<ConditionCh*> *all, vector<Condition*> *changed) {
-  vector<ConditionCh*>::const_iterator it, end = all->end();
-  for(it = all->begin(); it != end; ++it) (*it)->eval(*changed);
-}
-
 inline void eval_pwl() { //evaluate piece-wise linear inputs (e.g. 1, 1, 0)
-  static deque<Event>::iterator it = events.begin(), end = events.end();
-  while(it != end && it->active()) {
-    it->eval();
-    ++it;
+  static deque<Event>::const_iterator end = events.end();
+  while(next_event != end && next_event->active()) {
+    next_event->eval();
+    ++next_event;
   }
+  Source::eval(); //inputs generated on demand (e.g. stimulus files)
+  tInputs = t; //restored checkpoints replay the inputs up to it
 }
 
 void preinit_threads() {
@@ -279,6 +378,7 @@ void preinit_threads() {
 
 //init constant parts of Taylor polynomials (inputs x order):
 void init_mults(vector<vector<Number> > &mults) {
+  Memory::track(&mults);
   mults.reserve(maxInputs);
   for(size_t i = 0; i < maxInputs; ++i) {
     mults.push_back(vector<Number>());
@@ -289,6 +389,9 @@ void init_mults(vector<vector<Number> > &mults) {
 }
 
 void init_threads() {
+  deque<Group*>::const_iterator it, end = groups.end();
+  for(it = groups.begin(); it != end; ++it) (*it)->link(); //fanouts
+  for(it = groups.begin(); it != end; ++it) (*it)->start(); //check all first
   if(bThreaded && nThreads > groups.size()) {
     nThreads = groups.size();
     bThreaded = nThreads>1;
@@ -297,7 +400,6 @@ void init_threads() {
     threads.reserve(nThreads); //start threads:
     for(size_t i = 0; i < nThreads; i++) threads.add(new Worker);
     threads.run(); //run them (they wait for load)
-    deque<Group*>::const_iterator it, end = groups.end();
     for(it = groups.begin(); it != end; ++it) { //init
       Group *group = *it;
       assign(&group->assignments);
@@ -317,6 +419,14 @@ void init_threads() {
 void init_coeff() {
   coeff.reserve(maxInputs);
   for(size_t i = 1; i <= maxInputs; i++) coeff.push_back(Cinv*dt/i);
+  if(bPredict) { //all orders of the predictions, read by all threads
+    shared_mults.assign(maxInputs, vector<Number>(DEFAULT_ORDERS));
+    for(size_t i = 0; i < maxInputs; i++)
+      for(size_t j = 0; j < DEFAULT_ORDERS; j++)
+        shared_mults[i][j] = coeff[i]/(j+1);
+    Memory::track(&shared_mults);
+  }
+  SLEW = U*Gopen*Cinv*dt*DEFAULT_SLEW; //the fastest charging of a capacitor
 }
 
 bool init() {
@@ -325,50 +435,90 @@ bool init() {
   yyparse();
   yylex_destroy();
   if(error) return false;
+  Profile::phase(Profile::ELABORATE);
   if(isnanl(ONE)) ONE = -U/2; //default logical-one threshold (U is negative)
   if(mult > 0) { //print results only in multiplies of time
     nMult = roundl(mult/dt);
     bMult = nMult>1;
   }
   Expr::transform();
+  if(bOptimize) Term::optimize();
   Term::make_instr();
   sort(events.begin(), events.end());
+  next_event = events.begin();
+  return true;
+}
+
+bool init_variant() { //parameters of a variant are known; true if restored
+  Profile::phase(Profile::INIT);
+  if(bMixed && REST <= 0) REST = -U*DEFAULT_MIXED_SETTLE; //gates rest
+  STILL = bMixed && (SETTLE <= 0 || REST < SETTLE)? REST: SETTLE; //of gates
+  Source::init();
   init_coeff();
   init_threads();
-  return true;
+  Record::init(); //may choose a checkpoint of the previous run
+  bool bRestored = Checkpoint::init(eval_pwl); //inputs up to the restored t
+  Measure::init(bRestored);
+  if(bOutput && GRID > 0) { //dense output of the shown nets
+    map<string,Arg*>::const_iterator net, nend = Expr::numbers.end();
+    for(net = Expr::numbers.begin(); net != nend; ++net)
+      if(net->second->driver && shown(net->first)) net->second->driver->probe();
+  }
+  deque<Group*>::const_iterator it, end = groups.end();
+  for(it = groups.begin(); it != end; ++it) { //after dense output
+    (*it)->fuse();
+    if(bDedup) (*it)->classify();
+  }
+  Codegen::init(); //kernels of the gates without dense output
+  Profile::init();
+  return bRestored;
 }
 
 inline void par_taylor() { //parallel solver
   static deque<Group*>::const_iterator it, end = groups.end();
+  Number tStart = Profile::enabled()? microtime(): 0;
   for(it = groups.begin(); it != end; ++it) Worker::send2any(*it);
   Worker::wait4all();
+  if(tStart) Profile::step(microtime()-tStart);
+  ++curStep; //changed inputs schedule their gates in the next step
+  Profile::phase(Profile::CONDITIONS);
+  Counters::begin();
   for(it = groups.begin(); it != end; ++it) (*it)->perform_conditions();
+  Counters::end(Counters::CONDITIONS);
 }
 
 inline void ser_taylor() { //serial solver
+  Counters::begin();
   size_t ORD = curGroup->solve(*cur_mults);
+  Counters::end(Counters::SOLVE);
   if(ORD > MAXORD) MAXORD = ORD;
+  ++curStep; //changed inputs schedule their gates in the next step
+  Profile::phase(Profile::CONDITIONS);
+  Counters::begin();
   perform_conditions();
+  Counters::end(Counters::CONDITIONS);
 }
 
-size_t taylor(vector<vector<Number> > &mults, Gate *gate) { //solve one gate
+//terms from ORD on until TEST consecutive ones are negligible:
+size_t series(vector<vector<Number> > &mults, Gate *gate, size_t ORD,
+              Number &q) {
   bool bCont;
-  size_t n = 0, ORD = 1;
-  vector<Dae*> &daes = gate->daes;
-  vector<Dae*>::const_iterator it, end = daes.end();
-  for(it = daes.begin(); it != end; ++it) (*it)->first_term();
+  size_t n = 0;
+  vector<Dae*>::const_iterator it, end = gate->daes.end();
   do {
     bCont = false;
-    for(it = daes.begin(); it != end; ++it) {
+    for(it = gate->daes.begin(); it != end; ++it) {
       Dae *dae = *it;
       dae->eval_term(mults, ORD);
       if(dae->is_ode()) {
         dae->add_term();
+        if(ORD == 1 && ABS(dae->term()) > STILL) gate->bSettled = false;
         if(ABS(dae->term()) > EPS) { //reset counter if absolute val. is greater
           bCont = true;
           n = 0;
         }
       }
+      else if(bPower) q += *dae->result()/ORD; //the current is of order ORD-1
     } //continue until enough absolute values are less than or equal EPS:
     if(!bCont && ++n < TEST) bCont = true;
     ORD++;
@@ -376,19 +526,226 @@ size_t taylor(vector<vector<Number> > &mults, Gate *gate) { //solve one gate
   return --ORD; //ORD incremented once more than it should
 }
 
+size_t taylor(vector<vector<Number> > &mults, Gate *gate) { //solve one gate
+  Number q = 0; //integral of the total current over the step
+  vector<Dae*>::const_iterator it, end = gate->daes.end();
+  for(it = gate->daes.begin(); it != end; ++it) (*it)->first_term();
+  gate->bSettled = true;
+  size_t ORD = series(mults, gate, 1, q);
+  if(bPower) gate->q += q*dt;
+  return ORD;
+}
+
+//the term a after the term b is the last one needed if it and the tail of the
+//next ones, estimated by a geometric series of ratio a/b, are negligible:
+inline bool last_term(ConstNumber a, ConstNumber b) {
+  return a <= EPS && a*a <= EPS*(b-a); //a*r/(1-r) <= EPS for r = a/b
+}
+
+//one order of a fused gate; returns its current:
+template<size_t N> inline Number fused_term(Number *c, Number *r,
+                                            const Number *G, ConstNumber Gc,
+                                            ConstNumber m1, ConstNumber mN,
+                                            size_t ORD) {
+  Number cur = c[0];
+  for(size_t k = 1; k <= N; ++k) cur += c[k];
+  if(ORD == 1) cur += U;
+  cur *= Gc;
+  for(size_t k = 0; k <= N; ++k) {
+    c[k] *= G[k];
+    c[k] += cur;
+    c[k] *= k < N? m1: mN;
+    r[k] += c[k];
+  }
+  return cur;
+}
+
+//a NAND, NOR or NOT of N inputs (see Gate::fuse) in one pass with its state
+//in locals: the current, N series capacitors and the merged parallel one are
+//evaluated by the same operations as in taylor (or predict):
+template<size_t N> size_t fused(vector<vector<Number> > &mults, Gate *gate) {
+  Dae *const *daes = &gate->daes[0];
+  Dae &i = *daes[0], &p = *daes[N+1];
+  Number c[N+1], r[N+1], G[N+1], d[N+1], b[N+1], cur, q = 0;
+  ConstNumber Gc = *i.G; //Gi unless varied
+  for(size_t k = 0; k < N; ++k) {
+    r[k] = c[k] = daes[k+1]->start = daes[k+1]->res;
+    G[k] = *daes[k+1]->G;
+  }
+  r[N] = c[N] = p.start = p.res;
+  sum(p.args, G[N]);
+  *p.G = G[N];
+  bool bCont = true, bSettled = true;
+  size_t n = 0, ORD = 1, P = gate->next, last = 0; //P ~ predicted (0 ~ none)
+  if(P) { //without tests (see predict)
+    const Number *m1 = &shared_mults[0][0], *mN = &shared_mults[N-1][0];
+    for(; ORD <= P; ++ORD) {
+      if(ORD == P) for(size_t k = 0; k <= N; ++k) b[k] = ABS(c[k]);
+      cur = fused_term<N>(c, r, G, Gc, m1[ORD-1], mN[ORD-1], ORD);
+      if(bPower) q += cur/ORD;
+      if(ORD == 1) for(size_t k = 0; k <= N; ++k) d[k] = c[k];
+    }
+    bool bLess = P > 1; //the terms of order P-1 are negligible too
+    bCont = false;
+    for(size_t k = 0; k <= N; ++k) {
+      bCont = bCont || !last_term(ABS(c[k]), b[k]);
+      bLess = bLess && b[k] <= EPS;
+    }
+    last = bCont? P: bLess? P-2: P-1; //as in predict
+  }
+  while(bCont) {
+    bCont = false;
+    cur = fused_term<N>(c, r, G, Gc, Dae::mult(mults, 0, ORD),
+                        Dae::mult(mults, N-1, ORD), ORD);
+    if(bPower) q += cur/ORD;
+    for(size_t k = 0; k <= N; ++k) {
+      if(ORD == 1) d[k] = c[k];
+      if(ABS(c[k]) > EPS) {
+        bCont = true;
+        n = 0;
+        last = ORD;
+      }
+    }
+    if(!bCont && ++n < TEST) bCont = true;
+    ORD++;
+  }
+  i.res = cur;
+  for(size_t k = 0; k <= N; ++k) {
+    Dae &uc = *daes[k+1];
+    uc.res = r[k];
+    uc.cur_val = c[k];
+    uc.slope = d[k];
+    if(ABS(d[k]) > STILL) bSettled = false;
+  }
+  if(bPredict) gate->next = min<size_t>(last+1, DEFAULT_ORDERS);
+  gate->bSettled = bSettled;
+  if(bPower) gate->q += q*dt;
+  return --ORD;
+}
+
+size_t solve_fused(vector<vector<Number> > &mults, Gate *gate) {
+  switch(gate->fanin) { //unrolled by the compiler
+    case 1: return fused<1>(mults, gate);
+    case 2: return fused<2>(mults, gate);
+    case 3: return fused<3>(mults, gate);
+    case 4: return fused<4>(mults, gate);
+    default: return bPredict? predict(mults, gate): taylor(mults, gate);
+  }
+}
+
+//the order predicted from the last step (the last one of a greater term and
+//one more) is evaluated without any tests using the shared coefficients; it
+//holds if its last term is the last one needed (see last_term), else the
+//series continues as in taylor (which also follows changes of inputs):
+size_t predict(vector<vector<Number> > &mults, Gate *gate) {
+  size_t P = gate->next, ORD, last; //the last order of a greater term
+  if(!P) {
+    ORD = taylor(mults, gate);
+    gate->next = min<size_t>(ORD-TEST+1, DEFAULT_ORDERS);
+    return ORD;
+  }
+  Number q = 0;
+  vector<Dae*>::const_iterator it, end = gate->daes.end();
+  for(it = gate->daes.begin(); it != end; ++it) (*it)->first_term();
+  for(ORD = 1; ORD < P; ++ORD)
+    for(it = gate->daes.begin(); it != end; ++it) {
+      Dae *dae = *it;
+      dae->eval_term(&shared_mults[0], ORD);
+      if(dae->is_ode()) dae->add_term();
+      else if(bPower) q += *dae->result()/ORD;
+    }
+  bool bHolds = true, bLess = P > 1; //the terms of order P-1 are negligible
+  for(it = gate->daes.begin(); it != end; ++it) { //the last predicted order
+    Dae *dae = *it;
+    if(dae->is_ode()) {
+      ConstNumber b = ABS(dae->term()); //of order P-1
+      dae->eval_term(&shared_mults[0], P);
+      dae->add_term();
+      bHolds = bHolds && last_term(ABS(dae->term()), b);
+      bLess = bLess && b <= EPS;
+    }
+    else {
+      dae->eval_term(&shared_mults[0], P);
+      if(bPower) q += *dae->result()/P;
+    }
+  }
+  gate->bSettled = true;
+  for(it = gate->daes.begin(); it != end; ++it)
+    if((*it)->is_ode() && ABS((*it)->rate()) > STILL) gate->bSettled = false;
+  if(!bHolds) { //predicted too low
+    ORD = series(mults, gate, P+1, q);
+    last = ORD-TEST;
+  }
+  else {
+    ORD = P;
+    last = bLess? P-2: P-1;
+  }
+  gate->next = min<size_t>(last+1, DEFAULT_ORDERS);
+  if(bPower) gate->q += q*dt;
+  return ORD;
+}
+
+inline bool settled() { //are all the solved groups in a steady state?
+  if(!bThreaded) return curGroup->settled();
+  deque<Group*>::const_iterator it, end = groups.end();
+  for(it = groups.begin(); it != end; ++it) if(!(*it)->settled()) return false;
+  return true;
+}
+
+//skip the steps of a settled circuit until the next input change; returns
+//false if there are no more changes until tmax:
+inline bool fast_forward() {
+  if(SETTLE <= 0 || !settled()) return true;
+  Number tn = Source::next();
+  if(next_event != events.end() && next_event->time() < tn)
+    tn = next_event->time();
+  bool bCont = tn <= tmax;
+  Number steps = floorl(((bCont? tn: tmax)-t)/dt); //never skip the change
+  if(steps < 2) return true;
+  nSkipped += steps;
+  t += steps*dt;
+  if(bOutput) print_row(t); //the outputs are constant in between
+  curMult = 0;
+  if(GRID > 0) nGrid = floorl((t-tBegin)/GRID)+1; //the first one after t
+  return bCont;
+}
+
 bool solve() {
   t0 = microtime();
   if(!init()) return false;
-  print_header();
-  print_results();
+  if(Sweep::run()) return true; //the variants are finished
+  if(Fault::run()) return true; //the faulty copies are finished
+  bool bRestored = init_variant();
+  Fault::inject();
+  if(!bRestored) tBegin = t; //otherwise the output continues at its grid
+  if(bOutput) print_header();
+  Record::splice(); //the previous output before the restored time
+  if(!bRestored) print_results();
+  else if(GRID > 0) nGrid = floorl((t-tBegin)/GRID)+1; //the first one after t
+  else if(bOutput && !curMult) print_row(t); //the last row of the checkpoint
   while(t <= tmax) {
+    Profile::phase(Profile::INPUTS);
     eval_pwl(); //reflect changed piece-wise linear inputs (e.g. 1, 1, 0)
+    Profile::phase(Profile::SOLVE);
     if(bThreaded) par_taylor();
     else ser_taylor();
+    Profile::phase(Profile::OUTPUT);
+    Counters::begin();
+    Measure::step(); //crossings of measured nets within the step
     t += dt;
     print_results();
+    Counters::end(Counters::OUTPUT);
+    Fault::step(); //compare with the good machine
+    Checkpoint::step(); //every given number of steps or on SIGUSR1
+    Record::step();
+    Memory::step(); //samples of the subsystems
+    if(!fast_forward()) break;
   }
+  Record::finish();
   if(bDebug) print_debug();
+  Measure::report();
+  if(bPower) print_power();
   print_stats();
+  Profile::report();
   return true;
 }
@@ -0,0 +1,68 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __SOURCE_H__
+#define __SOURCE_H__
+
+#include "main.h"
+
+//inputs which produce their changes on demand instead of stored events:
+class Source {
+  static std::vector<Source*> sources;
+  static Number tNext; //the earliest change of all sources
+protected:
+  Number tn; //time of the next change (INFINITY if there is none)
+  static void set(Arg *arg, bool val) { //drive the input
+    Condition(val, arg).eval();
+  }
+public:
+  static void add(Source *source) {sources.push_back(source);}
+  static void eval() { //apply all due changes (see eval_pwl)
+    if(tNext > t) return;
+    tNext = INFINITY;
+    std::vector<Source*>::const_iterator it, end = sources.end();
+    for(it = sources.begin(); it != end; ++it) {
+      Source *source = *it;
+      while(source->tn <= t) source->fire();
+      if(source->tn < tNext) tNext = source->tn;
+    }
+  }
+  static void init() { //bind nets after elaboration
+    tNext = INFINITY;
+    std::vector<Source*>::const_iterator it, end = sources.end();
+    for(it = sources.begin(); it != end; ++it) {
+      (*it)->bind();
+      if((*it)->tn < tNext) tNext = (*it)->tn;
+    }
+  }
+  static ConstNumber next() {return tNext;}
+  static bool none() {return sources.empty();}
+  static void reopen() { //forked variants must not share file offsets
+    std::vector<Source*>::const_iterator it, end = sources.end();
+    for(it = sources.begin(); it != end; ++it) (*it)->detach();
+  }
+  Source(): tn(INFINITY) {}
+  virtual ~Source() {}
+  virtual void bind() = 0; //find driven nets and set their initial values
+  virtual void detach() {} //reopen files at the current position
+  virtual void fire() = 0; //apply the change at tn and find the next one
+};
+
+#endif
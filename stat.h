@@ -0,0 +1,59 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __STAT_H__
+#define __STAT_H__
+
+#include "defaults.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+class Stat { //minimum, mean and maximum of measured times
+  size_t n;
+  Number min, max, sum;
+public:
+  Stat(): n(0), min(INFINITY), max(-INFINITY), sum(0) {}
+  void add(ConstNumber x) {
+    ++n;
+    sum += x;
+    if(x < min) min = x;
+    if(x > max) max = x;
+  }
+  size_t count() const {return n;}
+  ConstNumber maximum() const {return max;}
+  ConstNumber minimum() const {return min;}
+  void print(const std::string &) const;
+  ConstNumber total() const {return sum;}
+};
+
+struct Load { //solve times of a group and the orders of its gates
+  Stat time;
+  std::vector<size_t> orders; //histogram
+  Number last; //solve time of the last step
+  Load(): last(0) {}
+  void add(ConstNumber x) {time.add(last = x);}
+  void count(size_t ORD) {
+    if(orders.size() <= ORD) orders.resize(ORD+1);
+    ++orders[ORD];
+  }
+};
+
+#endif
@@ -0,0 +1,150 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stimulus.h"
+#include <cstring>
+#include <stdint.h>
+using namespace std;
+
+const char STIMULUS_MAGIC[] = "FECSSTIM";
+
+Stimulus::Stimulus(const string &file): bBinary(false), line(0), file(file) {
+  buffer = new char[DEFAULT_STIMULUS_BUF];
+  in.rdbuf()->pubsetbuf(buffer, DEFAULT_STIMULUS_BUF); //only a small window
+  in.open(file.c_str(), ios::in | ios::binary);
+  if(!in) error_exit("Cannot open stimulus file \""+file+"\".");
+  read_header();
+}
+
+void Stimulus::error(const string &str) const {
+  stringstream ss;
+  ss << file;
+  if(!bBinary) ss << ":" << line;
+  error_exit(ss.str()+": "+str);
+}
+
+void Stimulus::read_header() { //names are resolved nets for streaming
+  char magic[sizeof(STIMULUS_MAGIC)-1];
+  in.read(magic, sizeof(magic));
+  if(in && !memcmp(magic, STIMULUS_MAGIC, sizeof(magic))) {
+    bBinary = true;
+    uint32_t n = 0;
+    in.read(reinterpret_cast<char*>(&n), sizeof(n));
+    for(uint32_t i = 0; i < n && in; ++i) {
+      names.push_back("");
+      getline(in, names.back(), '\0');
+    }
+    if(!in) error("Truncated header.");
+    packed.resize((n+7)/8);
+  }
+  else {
+    in.clear();
+    in.seekg(0);
+    string str, name;
+    while(getline(in, str)) { //skip empty lines and comments
+      ++line;
+      if(str.find_first_not_of(" \t\r") != string::npos && str[0] != '#') break;
+    }
+    stringstream ss(str);
+    ss >> name; //"t"
+    while(ss >> name) names.push_back(name);
+  }
+  if(names.empty()) error("Missing header with input names.");
+  vals.assign(names.size(), -1);
+  cur.assign(names.size(), -1);
+  vector<string>::const_iterator it, end = names.end();
+  for(it = names.begin(); it != end; ++it) Expr::define(*it);
+}
+
+void Stimulus::read() { //the next vector and its time
+  Number told = tn;
+  if(bBinary) {
+    double time;
+    if(!in.read(reinterpret_cast<char*>(&time), sizeof(time))) {
+      tn = INFINITY;
+      return;
+    }
+    if(!in.read(reinterpret_cast<char*>(&packed[0]), packed.size()))
+      error("Truncated record.");
+    tn = time;
+    for(size_t i = 0, size = vals.size(); i < size; ++i)
+      vals[i] = packed[i/8]>>i%8&1;
+  }
+  else {
+    string str;
+    do {
+      if(!getline(in, str)) {
+        tn = INFINITY;
+        return;
+      }
+      ++line;
+    } while(str.find_first_not_of(" \t\r") == string::npos || str[0] == '#');
+    const char *p = str.c_str();
+    char *endp;
+    tn = strtold(p, &endp);
+    if(endp == p) error("Missing time.");
+    p = endp;
+    for(size_t i = 0, size = vals.size(); i < size; ++i) {
+      while(*p == ' ' || *p == '\t') ++p;
+      switch(*p++) {
+        case '0': vals[i] = 0; break;
+        case '1': vals[i] = 1; break;
+        case '-': case 'x': case 'X': vals[i] = -1; break;
+        default: error("Expected 0, 1 or - for input \""+names[i]+"\".");
+      }
+    }
+  }
+  if(tn < told && !isinfl(told)) error("Times have to be non-decreasing.");
+}
+
+void Stimulus::detach() {
+  streampos pos = in.tellg();
+  in.close();
+  in.open(file.c_str(), ios::in | ios::binary);
+  if(!in || !in.seekg(pos))
+    error_exit("Cannot reopen stimulus file \""+file+"\".");
+}
+
+void Stimulus::bind() { //inputs are zero until their first vector
+  vector<string>::const_iterator it, end = names.end();
+  for(it = names.begin(); it != end; ++it) {
+    map<string,Arg*,num_greater>::const_iterator arg = Expr::numbers.find(*it);
+    if(arg == Expr::numbers.end()) {
+      cerr << "Warning: Stimulus input \"" << *it << "\" is not used." << endl;
+      args.push_back(NULL);
+    }
+    else {
+      args.push_back(arg->second);
+      set(arg->second, false);
+    }
+  }
+  cur.assign(names.size(), 0);
+  tn = INFINITY;
+  read();
+}
+
+void Stimulus::fire() { //apply the vector and read the next one
+  for(size_t i = 0, size = vals.size(); i < size; ++i)
+    if(vals[i] >= 0 && vals[i] != cur[i] && args[i]) {
+      cur[i] = vals[i];
+      set(args[i], cur[i]);
+    }
+  read();
+}
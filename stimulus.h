@@ -0,0 +1,53 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __STIMULUS_H__
+#define __STIMULUS_H__
+
+#include "main.h"
+#include "source.h"
+
+//timestamped input vectors streamed from a file; the text form has a header
+//"t name1 name2 ..." followed by lines "time v1 v2 ..." where v is 0, 1 or -
+//(unchanged); the binary form starts with "FECSSTIM", the number of inputs
+//(uint32) and NUL-terminated names followed by records consisting of time
+//(double) and values packed into bytes (LSB first):
+class Stimulus: public Source {
+  bool bBinary;
+  char *buffer; //for reading
+  size_t line; //for errors
+  std::ifstream in;
+  std::string file;
+  std::vector<Arg*> args; //driven inputs (NULL if not used)
+  std::vector<char> vals, cur; //the next and the applied values (-1 ~ keep)
+  std::vector<std::string> names;
+  std::vector<unsigned char> packed; //binary record
+  void error(const std::string &) const;
+  void read(); //read the next vector
+  void read_header();
+public:
+  Stimulus(const std::string &);
+  ~Stimulus() {delete [] buffer;}
+  void bind();
+  void detach();
+  void fire();
+};
+
+#endif
@@ -0,0 +1,132 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sweep.h"
+#include <cctype>
+#include <cstdio>
+#include <sys/wait.h>
+#include <unistd.h>
+using namespace std;
+
+vector<pair<string,vector<string> > > Sweep::params;
+size_t Sweep::nVariants = 0;
+Number Sweep::sigma = 0;
+unsigned long long Sweep::seed = 1;
+string Sweep::prefix = "variant";
+
+inline Number gauss(unsigned long long &state) { //xorshift64* and Box-Muller
+  Number u[2];
+  for(size_t i = 0; i < 2; ++i) {
+    state ^= state>>12; state ^= state<<25; state ^= state>>27;
+    u[i] = ((state*0x2545F4914F6CDD1DULL>>11)+0.5L)/(1ULL<<53);
+  }
+  return sqrtl(-2*logl(u[0]))*cosl(2*M_PI*u[1]);
+}
+
+void Sweep::add(const string &line) { //a parameter and its values
+  stringstream ss(line);
+  string name, value, lc;
+  ss >> name;
+  for(size_t i = 0; i < name.size(); ++i) lc += tolower(name[i]);
+  if(lc != "u" && lc != "one" && lc != "c" && lc != "ri" && lc != "ropen" &&
+     lc != "rclosed" && lc != "eps" && lc != "settle" && lc != "rest" &&
+     lc != "test" && lc != "grid") //the others are used during elaboration
+    error_exit("Sweep of \""+name+"\" is not supported (only u, one, c, ri, "
+               "ropen, rclosed, eps, settle, rest, test and grid).");
+  vector<string> values;
+  while(ss >> value) values.push_back(value);
+  if(values.empty()) error_exit("Sweep of \""+name+"\" has no values.");
+  if(!params.empty() && values.size() != params.front().second.size())
+    error_exit("All sweeps have to have the same number of values.");
+  params.push_back(make_pair(name, values));
+}
+
+void Sweep::apply(size_t k) { //parameters of the k-th variant
+  Number u = U;
+  vector<pair<string,vector<string> > >::const_iterator it, end = params.end();
+  for(it = params.begin(); it != end; ++it) set_const(it->first, it->second[k]);
+  if(U != u) { //initial voltages and the default threshold follow U
+    if(ONE == -u/2) ONE = -U/2;
+    deque<Group*>::const_iterator it, end = groups.end();
+    for(it = groups.begin(); it != end; ++it) (*it)->scale(U/u);
+  }
+  if(sigma > 0) { //per-gate variation of ri
+    unsigned long long state = seed+k*0x9E3779B97F4A7C15ULL;
+    if(!state) state = 1;
+    deque<Group*>::const_iterator it, end = groups.end();
+    for(it = groups.begin(); it != end; ++it) {
+      vector<Gate*>::const_iterator gate, gend = (*it)->end();
+      for(gate = (*it)->begin(); gate != gend; ++gate)
+        (*gate)->vary(max(1+sigma*gauss(state), 0.1L));
+    }
+  }
+}
+
+//fork the variants (at most one per processor at a time, which divide the
+//processors among their threads); returns true in the parent, false in the
+//variant which continues the simulation:
+bool Sweep::run() {
+  if(!params.empty()) { //one variant for each swept value
+    size_t n = params.front().second.size();
+    if(nVariants && nVariants != n)
+      error_exit("Variants have to match the number of swept values.");
+    nVariants = n;
+  }
+  if(!nVariants) return false;
+  size_t nCPUs = max(sysconf(_SC_NPROCESSORS_ONLN), 1L), running = 0;
+  size_t failed = 0, share = nCPUs/min(nVariants, nCPUs);
+  cout.flush();
+  cerr.flush();
+  for(size_t k = 0; k < nVariants || running; ) {
+    if(k < nVariants && running < nCPUs) {
+      pid_t pid = fork();
+      if(pid < 0) error_exit("Cannot fork a variant.");
+      if(!pid) { //the variant
+        string name = prefix+num2str(k);
+        if(!freopen((name+".tsv").c_str(), "w", stdout) ||
+           !freopen((name+".log").c_str(), "w", stderr))
+          error_exit("Cannot write results of variant "+num2str(k)+".");
+        Source::reopen();
+        Checkpoint::suffix("."+num2str(k));
+        Record::suffix("."+num2str(k));
+        Memory::suffix("."+num2str(k));
+        Profile::suffix("."+num2str(k));
+        if(nThreads > share) { //processors of the variant
+          nThreads = share;
+          bThreaded = nThreads>1;
+        }
+        apply(k);
+        return false;
+      }
+      ++running;
+      ++k;
+    }
+    else {
+      int status;
+      if(wait(&status) < 0) break;
+      --running;
+      if(!WIFEXITED(status) || WEXITSTATUS(status)) ++failed;
+    }
+  }
+  if(failed) error_exit(num2str(failed)+" of "+num2str(nVariants)+
+                        " variants failed.");
+  cerr << "Variants: " << nVariants << endl;
+  return true;
+}
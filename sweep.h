@@ -0,0 +1,48 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __SWEEP_H__
+#define __SWEEP_H__
+
+#include "main.h"
+
+//variants of one elaborated circuit, e.g. sweep = "ropen 0.5 0.6 0.7" sets
+//ropen per variant (only parameters used after elaboration can be swept,
+//variants has to match the number of values if both are set) and
+//sigma = 0.05 varies ri of each gate randomly; each variant is a forked
+//process sharing the circuit until it is changed and writes prefix<k>.tsv
+//(results) and prefix<k>.log (statistics):
+class Sweep {
+  static std::vector<std::pair<std::string,std::vector<std::string> > > params;
+  static size_t nVariants;
+  static Number sigma;
+  static unsigned long long seed;
+  static std::string prefix;
+  static void apply(size_t);
+public:
+  static void add(const std::string &);
+  static bool run();
+  static void set_prefix(const std::string &prefix) {Sweep::prefix = prefix;}
+  static void set_seed(unsigned long long seed) {Sweep::seed = seed;}
+  static void set_sigma(ConstNumber sigma) {Sweep::sigma = sigma;}
+  static void set_variants(size_t n) {nVariants = n;}
+};
+
+#endif
@@ -0,0 +1,101 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "dae.h"
+using namespace std;
+
+size_t Memory::cur[TAGS], Memory::peak[TAGS], Memory::objects[TAGS],
+  Memory::held[TAGS];
+vector<const vector<vector<Number> >*> Memory::mults;
+string Memory::file;
+
+static const char *tags[] = {"exprs", "terms", "daes", "gates", "groups",
+  "networks", "conditions", "nets", "events", "mults", "pointers"};
+
+void Memory::set(Tag tag, size_t size, size_t n) { //measured container
+  cur[tag] = size;
+  objects[tag] = n;
+  if(size > peak[tag]) peak[tag] = size;
+}
+
+void Memory::hold(Tag tag, size_t size) { //containers of the live objects
+  shrink(tag, held[tag]);
+  grow(tag, size);
+  held[tag] = size;
+}
+
+void Memory::track(const vector<vector<Number> > *table) { //of a thread
+  static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+  pthread_mutex_lock(&mutex);
+  mults.push_back(table);
+  pthread_mutex_unlock(&mutex);
+}
+
+void Memory::measure() { //containers between steps
+  set(EVENTS, events.size()*sizeof(Event), events.size());
+  size_t size = 0, n = 0;
+  vector<const vector<vector<Number> >*>::const_iterator it, end = mults.end();
+  for(it = mults.begin(); it != end; ++it) {
+    vector<vector<Number> >::const_iterator row, rend = (*it)->end();
+    for(row = (*it)->begin(); row != rend; ++row) {
+      size += row->capacity()*sizeof(Number);
+      n += row->size();
+    }
+  }
+  set(MULTS, size, n);
+  size = 0; //nodes of the map are estimated by their values and 4 pointers
+  map<const void*,string>::const_iterator ptr, pend = pointers.end();
+  for(ptr = pointers.begin(); ptr != pend; ++ptr)
+    size += sizeof(*ptr)+4*sizeof(void*)+ptr->second.capacity();
+  set(POINTERS, size, pointers.size());
+  size_t bytes[TAGS] = {0};
+  deque<Group*>::const_iterator group, gend = groups.end();
+  for(group = groups.begin(); group != gend; ++group) (*group)->heap(bytes);
+  hold(GROUPS, bytes[GROUPS]);
+  hold(GATES, bytes[GATES]);
+  hold(DAES, bytes[DAES]);
+  hold(NETWORKS, bytes[NETWORKS]);
+}
+
+void Memory::report(ostream &out) {
+  static Number pagesize = sysconf(_SC_PAGE_SIZE);
+  measure();
+  for(size_t i = 0; i < TAGS; ++i)
+    if(peak[i])
+      out << "Memory of " << tags[i] << ": " << hr(cur[i]/pagesize)
+          << " (peak " << hr(peak[i]/pagesize) << ") in " << objects[i]
+          << " objects" << endl;
+}
+
+void Memory::step() { //current bytes of the subsystems every few steps
+  static ofstream out;
+  if(file == "" || curStep%DEFAULT_MEMORY_STEPS) return;
+  if(!out.is_open()) {
+    out.open(file.c_str());
+    if(!out) error_exit("Cannot write memory samples \""+file+"\".");
+    out << "t";
+    for(size_t i = 0; i < TAGS; ++i) out << "\t" << tags[i];
+    out << endl;
+  }
+  measure();
+  out << t;
+  for(size_t i = 0; i < TAGS; ++i) out << "\t" << cur[i];
+  out << endl;
+}
@@ -0,0 +1,90 @@
+/*
+  FECS: Fast Electronic Circuits Simulator
+  Copyright (C) 2017 Filip Kocina
+
+  This file is part of FECS.
+
+  FECS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  FECS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with FECS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __TAGGED_H__
+#define __TAGGED_H__
+
+#include "defaults.h"
+#include <cstddef>
+#include <iosfwd>
+#include <new>
+#include <string>
+#include <vector>
+
+//current and peak bytes and object counts of the subsystems; objects are
+//counted by the operators new and delete of Tagged, containers are measured
+//when they are reported or sampled (e.g. memory = "mem.tsv") and those of
+//exprs and terms while they are lowered:
+class Memory {
+public:
+  enum Tag {EXPRS, TERMS, DAES, GATES, GROUPS, NETWORKS, CONDITIONS, NETS,
+    EVENTS, MULTS, POINTERS, TAGS};
+private:
+  static size_t cur[TAGS], peak[TAGS], objects[TAGS], held[TAGS];
+  static std::vector<const std::vector<std::vector<Number> >*> mults;
+  static std::string file;
+  static void hold(Tag, size_t);
+  static void measure();
+public:
+  static void alloc(Tag tag, size_t size) { //thread-safe (elaboration)
+    grow(tag, size);
+    __sync_add_and_fetch(&objects[tag], 1);
+  }
+  static void free(Tag tag, size_t size) {
+    shrink(tag, size);
+    __sync_sub_and_fetch(&objects[tag], 1);
+  }
+  static void grow(Tag tag, size_t size) { //bytes without objects
+    size_t now = __sync_add_and_fetch(&cur[tag], size), old;
+    while((old = peak[tag]) < now &&
+          !__sync_bool_compare_and_swap(&peak[tag], old, now));
+  }
+  template<typename T> static size_t heap(const std::vector<T> &vec) {
+    return vec.capacity()*sizeof(T);
+  }
+  static size_t heap(const std::vector<bool> &vec) {return vec.capacity()/8;}
+  static size_t heap(const std::string &str) { //short ones are inline
+    return str.capacity() < sizeof(str)? 0: str.capacity()+1;
+  }
+  static void shrink(Tag tag, size_t size) {
+    __sync_sub_and_fetch(&cur[tag], size);
+  }
+  static void report(std::ostream &);
+  static void set(Tag, size_t, size_t);
+  static void set_file(const std::string &name) {file = name;}
+  static void step(); //after the step
+  static void suffix(const std::string &str) { //one file per variant
+    if(file != "") file += str;
+  }
+  static void track(const std::vector<std::vector<Number> > *table);
+};
+
+template<Memory::Tag TAG> struct Tagged { //counts the objects of a subsystem
+  static void *operator new(size_t size) {
+    Memory::alloc(TAG, size);
+    return ::operator new(size);
+  }
+  static void operator delete(void *ptr, size_t size) {
+    Memory::free(TAG, size);
+    ::operator delete(ptr);
+  }
+};
+
+#endif
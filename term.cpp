@@ -21,35 +21,163 @@
 #include "term.h"
 using namespace std;
 
-deque<const Term*> Term::terms;
-size_t Term::nTrans = 0, Term::nINVs = 0, Term::nNANDs = 0, Term::nNORs = 0;
+deque<Term*> Term::terms;
+__thread size_t Term::nTrans = 0, Term::nINVs = 0, Term::nNANDs = 0,
+  Term::nNORs = 0, Term::nCGs = 0, Term::nInputs = 0;
+size_t Term::nRemoved = 0;
+vector<Chunk> Elaborator::chunks;
+const deque<Term*> *Elaborator::terms = NULL;
+size_t Elaborator::next = 0;
+
+inline Arg *resolve(const map<Arg*,Arg*> &aliases, Arg *arg) {
+  map<Arg*,Arg*>::const_iterator it, end = aliases.end();
+  while((it = aliases.find(arg)) != end) arg = it->second; //replaced nets
+  return arg;
+}
+
+//nets on combinational cycles, i.e. in strongly connected components of
+//the gates (iterative Tarjan's algorithm, rings may be long):
+set<Arg*> Term::cyclic(const map<Arg*,Term*> &drivers) {
+  map<Arg*,size_t> index, low;
+  vector<Arg*> stack;
+  set<Arg*> onStack, res;
+  vector<pair<Arg*,size_t> > path; //nets and their next argument
+  size_t n = 0;
+  deque<Term*>::const_iterator it, end = terms.end();
+  for(it = terms.begin(); it != end; ++it) {
+    if((*it)->type == BITS || index.count((*it)->res)) continue;
+    path.push_back(make_pair((*it)->res, 0));
+    while(!path.empty()) {
+      Arg *net = path.back().first;
+      size_t &next = path.back().second;
+      if(!index.count(net)) { //the first visit
+        index[net] = low[net] = n++;
+        stack.push_back(net);
+        onStack.insert(net);
+      }
+      map<Arg*,Term*>::const_iterator d = drivers.find(net);
+      const vector<Arg*> &args = d->second->args;
+      if(next < args.size()) {
+        Arg *arg = args[next++];
+        map<Arg*,Term*>::const_iterator a = drivers.find(arg);
+        if(a == drivers.end() || a->second->type == BITS) continue; //inputs
+        if(arg == net) res.insert(net); //a gate driving itself
+        if(!index.count(arg)) path.push_back(make_pair(arg, 0));
+        else if(onStack.count(arg)) low[net] = min(low[net], index[arg]);
+        continue;
+      }
+      path.pop_back();
+      if(!path.empty())
+        low[path.back().first] = min(low[path.back().first], low[net]);
+      if(low[net] != index[net]) continue; //not the root of a component
+      vector<Arg*>::iterator root = stack.end();
+      while(*--root != net); //the nets above it form the component
+      if(stack.end()-root > 1) res.insert(root, stack.end());
+      for(vector<Arg*>::iterator top = root; top != stack.end(); ++top)
+        onStack.erase(*top);
+      stack.erase(root, stack.end());
+    }
+  }
+  return res;
+}
 
 Term::Term(Expr *e): bIV(false), res(e->res), type(e->type) {
   if(type == BITS) bits = e->bits;
-  else { //evaluate default initial values and add arguments:
-    bool bIV = false, val = false, nval = true; //for NAND
-    if(type == NOR) bIV = true, val = true, nval = false;
+  else { //add arguments and evaluate default initial values:
+    vector<bool> ivs;
     vector<Expr*>::const_iterator it, end = e->args.end();
     for(it = e->args.begin(); it != end; ++it) {
       Expr *expr = *it;
-      if((expr->iv>0) == val) bIV = nval;
-      args.push_back(expr->out());
+      if(expr->type == GROUP) { //e.g. aoi((a, b), c)
+        if(type != AOI && type != OAI)
+          error_exit("Groups of arguments are allowed only in AOI and OAI.");
+        vector<Expr*>::const_iterator it2, end2 = expr->args.end();
+        for(it2 = expr->args.begin(); it2 != end2; ++it2) add(*it2, ivs);
+        sizes.push_back(expr->args.size());
+      }
+      else {
+        add(expr, ivs);
+        if(type == AOI || type == OAI) sizes.push_back(1);
+      }
     }
+    bool bIV = logic(ivs);
     if(e->iv < 0) e->iv = bIV, this->bIV = bIV;
     else this->bIV = e->iv;
   }
   reg();
 }
 
+void Term::add_counts(const Counts &counts) { //merge counts of a thread
+  Dae::add_counts(counts.algs, counts.odes);
+  nTrans += counts.trans;
+  nINVs += counts.invs;
+  nNANDs += counts.nands;
+  nNORs += counts.nors;
+  nCGs += counts.cgs;
+  mark_inputs(counts.inputs);
+}
+
+void Term::get_counts(Counts &counts) { //counts of this thread
+  counts.algs = Dae::algs();
+  counts.odes = Dae::odes();
+  counts.trans = nTrans;
+  counts.invs = nINVs;
+  counts.nands = nNANDs;
+  counts.nors = nNORs;
+  counts.cgs = nCGs;
+  counts.inputs = nInputs;
+}
+
+void Term::make_instr() { //debug descriptions are not thread-safe:
+  if(bThreaded && !bDebug && terms.size() > DEFAULT_ELAB_CHUNK)
+    Elaborator::lower(terms);
+  else lower();
+  if(nInputs > maxInputs) maxInputs = nInputs;
+  mark_mem_sz(); terms = deque<Term*>(); //mark memory usage
+}
+
 void Term::add(Expr *e) {
   args.push_back(e->out());
 }
 
+void Term::add(Expr *e, vector<bool> &ivs) { //the argument and its init. value
+  if(e->type == GROUP) error_exit("Groups of arguments cannot be nested.");
+  args.push_back(e->out());
+  ivs.push_back(e->iv > 0);
+}
+
+bool logic(Type type, const vector<size_t> &sizes, const vector<bool> &in) {
+  size_t ones = count(in.begin(), in.end(), true); //logical function of a gate
+  switch(type) {
+    case NOR: return !ones;
+    case XOR: return ones%2;
+    case XNOR: return !(ones%2);
+    case AOI: case OAI: { //not(or of ands) or not(and of ors)
+      bool bAOI = type==AOI, val = !bAOI;
+      vector<bool>::const_iterator it = in.begin();
+      vector<size_t>::const_iterator size, end = sizes.end();
+      for(size = sizes.begin(); size != end; ++size) {
+        bool group = bAOI;
+        for(size_t i = 0; i < *size; ++i, ++it)
+          group = bAOI? group && *it: group || *it;
+        val = bAOI? val || group: val && group;
+      }
+      return !val;
+    }
+    case MUX: return in.size() == 3 && in[in[0]? 2: 1]; //mux(s, a, b)
+    default: return ones < in.size(); //NAND, NOT
+  }
+}
+
+bool Term::logic(const vector<bool> &in) const {
+  return ::logic(type, sizes, in);
+}
+
 void Term::instr_bits() const { //bits -> discrete events
   vector<bool>::const_iterator it, end = bits.end();
   Number tn = t, dt = (tmax-t)/bits.size();
   for(it = bits.begin(); it != end; ++it) {
-    events.push_back(Event(tn, *it, &res->Gn, &res->Gp));
+    cur_events->push_back(Event(tn, *it, res));
     tn += dt;
   }
 }
@@ -58,7 +186,7 @@ void Term::instr_bits() const { //bits -> discrete events
 void Term::make_par(Dae *i, Number Arg::*G, bool bIV, Arg *arg) const {
   size_t size = args.size();
   Dae *uc = new Dae(size, i, NULL, bIV? -U: 0); //capacitors are merged
-  if(size > maxInputs) maxInputs = size; //mark if more inputs
+  mark_inputs(size); //mark if more inputs
   vector<Arg*>::const_iterator it, end = args.end();
   uc->reserve(size); //arguments are driven by Gn or Gp:
   for(it = args.begin(); it != end; ++it) uc->add(&(*it->*G));
@@ -81,7 +209,10 @@ Dae *Term::make_ser(Number Arg::*G, bool bIV, Arg *arg) const {
   Number iv = bIV? -U/size: 0; //initial values of all ser. capac. must give -U
   for(it = args.begin(); it != end; ++it) {
     Dae *uc = new Dae(1, i, &(*it->*G), iv); //an ODE for each transistor
-    if(assignment) assignment->add(uc->result()); //results are summed on need
+    if(assignment) { //results are summed on need
+      assignment->add(uc->result());
+      assignment->trace(uc);
+    }
   }
   if(assignment) assignment->set_out(arg);
   return i;
@@ -112,8 +243,247 @@ void Term::instr_not() const {
   instr_nor();
 }
 
+Network *Term::pull_down() const { //conducts when the output is zero
+  Network *net = new Network;
+  size_t size = args.size();
+  switch(type) {
+    case XOR: case XNOR: { //minterms with even (XOR) or odd (XNOR) parity
+      size_t n = 0;
+      for(size_t m = 0; m < 1U<<size; ++m) {
+        size_t ones = 0;
+        for(size_t i = 0; i < size; ++i) ones += m>>i&1;
+        if(ones%2 != (type==XNOR)) continue;
+        for(size_t i = 0; i < size; ++i) net->leaf(args[i], !(m>>i&1));
+        net->ser(size);
+        ++n;
+      }
+      net->par(n);
+      break;
+    }
+    case AOI: case OAI: { //groups are in series (AOI) or in parallel (OAI)
+      vector<Arg*>::const_iterator it = args.begin();
+      vector<size_t>::const_iterator group, end = sizes.end();
+      for(group = sizes.begin(); group != end; ++group) {
+        for(size_t i = 0; i < *group; ++i, ++it) net->leaf(*it, false);
+        if(type == AOI) net->ser(*group);
+        else net->par(*group);
+      }
+      if(type == AOI) net->par(sizes.size());
+      else net->ser(sizes.size());
+      break;
+    }
+    case MUX: //mux(s, a, b) is zero for not(s) and not(a) or s and not(b)
+      net->leaf(args[0], true);
+      net->leaf(args[1], true);
+      net->ser(2);
+      net->leaf(args[0], false);
+      net->leaf(args[2], true);
+      net->ser(2);
+      net->par(2);
+      break;
+    default: error_exit("Gate has no compound network."); //basic gates
+  }
+  return net;
+}
+
+//compound gate whose pull-down and pull-up networks are merged into one
+//capacitor each; negated arguments need no inverters:
+void Term::instr_native() const {
+  if(args.empty()) error_exit("Compound gates have to have arguments.");
+  if((type == XOR || type == XNOR) && args.size() < 2)
+    error_exit("XOR and XNOR have to have at least two arguments.");
+  if((type == XOR || type == XNOR) && args.size() > DEFAULT_MAX_XOR)
+    error_exit("XOR and XNOR can have at most "+num2str(DEFAULT_MAX_XOR)+
+               " arguments.");
+  if(type == MUX && args.size() != 3)
+    error_exit("MUX has to have exactly three arguments.");
+  Network *down = pull_down(), *up = down->dual();
+  add_trans(down->size()+up->size()); //log number of transistors
+  inc_cgs();
+  size_t wdown = down->width(), wup = up->width();
+  mark_inputs(wdown); //mark if more merged capacitors
+  mark_inputs(wup);
+  set_current_group();
+  Dae *i = new Dae;
+  i->reserve(2);
+  Dae *uc = new Dae(wdown, i, NULL, bIV? -U: 0); //output voltage
+  uc->set_net(down);
+  uc->set_out(res);
+  uc = new Dae(wup, i, NULL, bIV? 0: -U);
+  uc->set_net(up);
+  curGroup->add_size(); //mark number of ODEs
+}
+
 void Term::set_current_group() const { //maxSize can be changed by param. bunch
-  if(groups.empty() || bThreaded && curGroup->size() >= maxSize)
-    groups.push_back(new Group);
-  curGroup->add();
+  if(cur_groups->empty() || bThreaded && curGroup->size() >= maxSize)
+    cur_groups->push_back(new Group);
+  curGroup->add(args, res, type, sizes);
+}
+
+//structural hashing, double-inversion removal, constant propagation and
+//dead-gate elimination relative to the shown variables:
+void Term::optimize() {
+  map<Arg*,Term*> drivers;
+  map<Arg*,bool> consts; //nets with a constant logical value
+  map<Arg*,Arg*> aliases; //nets replaced by logically equivalent ones
+  map<Arg*,vector<string> > names; //shown nets
+  set<Term*> removed;
+  deque<Term*>::const_iterator it, end = terms.end();
+  for(it = terms.begin(); it != end; ++it) drivers[(*it)->res] = *it;
+  set<Arg*> loops = cyclic(drivers); //e.g. rings keep their inverters
+  map<string,Arg*,num_greater>::const_iterator n, nend = Expr::numbers.end();
+  for(n = Expr::numbers.begin(); n != nend; ++n) {
+    map<Arg*,Term*>::const_iterator d = drivers.find(n->second);
+    if(d != drivers.end() && d->second->type != BITS &&
+       (shown(n->first) || Measure::measured(n->first)))
+      names[n->second].push_back(n->first); //only gates have voltage
+  }
+  bool bChanged;
+  do {
+    bChanged = false;
+    map<pair<vector<Arg*>,int>,Term*> hashes; //(sorted args, type and iv)
+    for(it = terms.begin(); it != end; ++it) {
+      Term *term = *it;
+      if(removed.count(term)) continue;
+      if(term->type == BITS) { //constant inputs
+        if(term->bits.empty()) continue;
+        vector<bool>::const_iterator b, bend = term->bits.end();
+        for(b = term->bits.begin(); b != bend && *b == term->bits.front(); ++b);
+        if(b == bend) consts[term->res] = term->bits.front();
+        continue;
+      }
+      vector<Arg*>::iterator a, aend = term->args.end();
+      for(a = term->args.begin(); a != aend; ++a) {
+        Arg *arg = resolve(aliases, *a);
+        if(arg != *a) *a = arg, bChanged = true;
+      }
+      if(term->type != NAND && term->type != NOR && term->type != NOT) continue;
+      vector<Arg*> args; //arguments without non-controlling constants
+      bool ctrl = term->type!=NAND, bConst = false, val = ctrl;
+      for(a = term->args.begin(); a != aend; ++a) {
+        Arg *arg = *a;
+        map<Arg*,bool>::const_iterator c = consts.find(arg);
+        if(c == consts.end()) args.push_back(arg);
+        else if(c->second == ctrl) bConst = true, val = !ctrl; //controlling
+      }
+      if(args.empty()) bConst = true; //all inputs are non-controlling
+      if(bConst) { //the output is constant:
+        if(!consts.count(term->res)) consts[term->res] = val, bChanged = true;
+        if(!names.count(term->res)) { //replace the gate by a constant input
+          term->type = BITS;
+          term->args.clear();
+          term->bits.assign(1, val);
+          ++nRemoved;
+        }
+        continue;
+      }
+      if(args.size() != term->args.size()) term->args = args, bChanged = true;
+      Arg *out = NULL; //logically equivalent net
+      if(term->inverter() && !loops.count(term->res)) { //not(not(x)) ~ x
+        map<Arg*,Term*>::const_iterator d = drivers.find(term->args.front());
+        if(d != drivers.end() && !removed.count(d->second) &&
+           d->second->type != BITS && d->second->inverter()) {
+          out = resolve(aliases, d->second->args.front());
+          map<Arg*,Term*>::const_iterator x = drivers.find(out);
+          if(out == term->res || (names.count(term->res) &&
+             (x == drivers.end() || x->second->type == BITS)))
+            out = NULL; //a shown net needs voltage
+        }
+      }
+      if(!out) { //structural hashing:
+        args = term->args;
+        sort(args.begin(), args.end());
+        int key = (term->inverter()? NOT: term->type)*2+term->bIV;
+        Term *&same = hashes[make_pair(args, key)];
+        if(same && same != term) out = same->res;
+        else same = term;
+      }
+      if(out) { //replace the output of the gate
+        aliases[term->res] = out;
+        map<Arg*,vector<string> >::iterator names2 = names.find(term->res);
+        if(names2 != names.end()) { //rebind shown variables
+          vector<string>::const_iterator name, nend = names2->second.end();
+          for(name = names2->second.begin(); name != nend; ++name)
+            Expr::numbers[*name] = out;
+          vector<string> &to = names[out];
+          to.insert(to.end(), names2->second.begin(), names2->second.end());
+          names.erase(term->res);
+        }
+        removed.insert(term);
+        bChanged = true;
+      }
+    }
+  } while(bChanged);
+  set<Term*> live; //dead-gate elimination:
+  vector<Term*> stack;
+  map<Arg*,vector<string> >::const_iterator o, oend = names.end();
+  for(o = names.begin(); o != oend; ++o) {
+    map<Arg*,Term*>::const_iterator d = drivers.find(o->first);
+    if(d != drivers.end() && live.insert(d->second).second)
+      stack.push_back(d->second);
+  }
+  while(!stack.empty()) {
+    Term *term = stack.back();
+    stack.pop_back();
+    vector<Arg*>::const_iterator a, aend = term->args.end();
+    for(a = term->args.begin(); a != aend; ++a) {
+      map<Arg*,Term*>::const_iterator d = drivers.find(*a);
+      if(d != drivers.end() && live.insert(d->second).second)
+        stack.push_back(d->second);
+    }
+  }
+  deque<Term*> kept;
+  for(it = terms.begin(); it != end; ++it)
+    if(live.count(*it)) kept.push_back(*it);
+    else { //gates replaced by constants were counted already
+      if((*it)->type != BITS) ++nRemoved;
+      delete *it;
+    }
+  terms.swap(kept);
+}
+
+void Elaborator::lower(const deque<Term*> &terms) { //chunks are independent
+  size_t size = terms.size(), bytes = Term::hold(terms);
+  size_t n = (size+DEFAULT_ELAB_CHUNK-1)/DEFAULT_ELAB_CHUNK;
+  chunks.resize(n);
+  for(size_t i = 0; i < n; ++i) {
+    chunks[i].begin = i*DEFAULT_ELAB_CHUNK;
+    chunks[i].end = min(size, chunks[i].begin+DEFAULT_ELAB_CHUNK);
+  }
+  Elaborator::terms = &terms;
+  next = 0;
+  Threads elaborators;
+  vector<Elaborator*> list;
+  size_t nElab = min<size_t>(nThreads, n);
+  elaborators.reserve(nElab);
+  for(size_t i = 0; i < nElab; ++i) {
+    list.push_back(new Elaborator);
+    elaborators.add(list.back());
+  }
+  elaborators.run();
+  elaborators.join();
+  vector<Elaborator*>::const_iterator it, end = list.end();
+  for(it = list.begin(); it != end; ++it) Term::add_counts((*it)->counts);
+  vector<Chunk>::iterator chunk, cend = chunks.end(); //deterministic order:
+  for(chunk = chunks.begin(); chunk != cend; ++chunk) {
+    groups.insert(groups.end(), chunk->groups.begin(), chunk->groups.end());
+    events.insert(events.end(), chunk->events.begin(), chunk->events.end());
+  }
+  chunks = vector<Chunk>();
+  Memory::shrink(Memory::TERMS, bytes);
+  if(!groups.empty()) groups.back()->select();
+}
+
+void Elaborator::run() {
+  size_t i;
+  while((i = __sync_fetch_and_add(&next, 1)) < chunks.size()) {
+    Chunk &chunk = chunks[i];
+    cur_events = &chunk.events; //results are stored per chunk
+    cur_groups = &chunk.groups;
+    for(size_t j = chunk.begin; j < chunk.end; ++j) {
+      (*terms)[j]->instr();
+      delete (*terms)[j];
+    }
+  }
+  Term::get_counts(counts);
 }
@@ -22,39 +22,75 @@
 #define __TERM_H__
 
 #include "main.h"
+#include "threads.h"
 
-class Term {
-  static std::deque<const Term*> terms;
-  static size_t nTrans, nINVs, nNANDs, nNORs; //counts
+struct Counts { //elaboration statistics of a thread
+  size_t algs, odes, trans, invs, nands, nors, cgs, inputs;
+};
+
+class Term: public Tagged<Memory::TERMS> {
+  static std::deque<Term*> terms;
+  static __thread size_t nTrans, nINVs, nNANDs, nNORs, nCGs, nInputs; //counts
+  static size_t nRemoved;
   static void add_trans(size_t n) {nTrans += n;}
+  static std::set<Arg*> cyclic(const std::map<Arg*,Term*> &);
   static void inc_invs() {++nINVs;}
   static void inc_nands() {++nNANDs;}
   static void inc_nors() {++nNORs;}
+  static void inc_cgs() {++nCGs;}
+  static void mark_inputs(size_t n) {if(n > nInputs) nInputs = n;}
   Arg *res; //result
   bool bIV; //initial value
   Type type;
   std::vector<Arg*> args;
   std::vector<bool> bits;
+  std::vector<size_t> sizes; //sizes of the groups of arguments (AOI, OAI)
+  void add(Expr *, std::vector<bool> &);
+  size_t heap() const { //bytes of its containers
+    return Memory::heap(args)+Memory::heap(bits)+Memory::heap(sizes);
+  }
+  static size_t hold(const std::deque<Term*> &terms) { //while they are lowered
+    size_t size = 0;
+    std::deque<Term*>::const_iterator it, end = terms.end();
+    for(it = terms.begin(); it != end; ++it) size += (*it)->heap();
+    Memory::grow(Memory::TERMS, size);
+    return size;
+  }
+  bool inverter() const {
+    return type == NOT || ((type == NAND || type == NOR) && args.size()==1);
+  }
+  bool logic(const std::vector<bool> &) const;
   void instr_bits() const;
+  void instr_native() const;
   void instr_nand() const;
   void instr_nor() const;
   void instr_not() const;
   void make_par(Dae *, Number Arg::*, bool, Arg * = NULL) const;
   Dae *make_ser(Number Arg::*, bool, Arg * = NULL) const;
+  Network *pull_down() const;
   void reg() {terms.push_back(this);}
   void set_current_group() const;
+  friend class Elaborator;
   friend Expr;
 public:
-  static size_t gates() {return nINVs+nNANDs+nNORs;}
+  static void add_counts(const Counts &);
+  static size_t compounds() {return nCGs;}
+  static size_t gates() {return nINVs+nNANDs+nNORs+nCGs;}
   static size_t invs() {return nINVs;}
-  static void make_instr() { //transform to differential equations
-    std::deque<const Term*>::const_iterator it, end = terms.end();
+  static void lower() { //transform registered terms and release them
+    size_t size = hold(terms);
+    std::deque<Term*>::const_iterator it, end = terms.end();
     for(it = terms.begin(); it != end; ++it) (*it)->instr();
     for(it = terms.begin(); it != end; ++it) delete *it;
-    mark_mem_sz(); terms = std::deque<const Term*>(); //mark memory usage
+    terms.clear();
+    Memory::shrink(Memory::TERMS, size);
   }
+  static void get_counts(Counts &);
+  static void make_instr(); //transform to differential equations
   static size_t nands() {return nNANDs;}
   static size_t nors() {return nNORs;}
+  static void optimize();
+  static size_t removed() {return nRemoved;}
   static size_t trans() {return nTrans;}
   Term(Expr *);
   Term(Type type): bIV(false), res(NULL), type(type) {reg();}
@@ -69,10 +105,28 @@ public:
       case NAND: instr_nand(); break;
       case NOR: instr_nor(); break;
       case NOT: instr_not(); break;
+      case XOR: case XNOR: case AOI: case OAI: case MUX: instr_native(); break;
+      default: break; //no other types are lowered
     }
   }
   void set_iv(bool iv) {bIV = iv;}
   void set_res(Arg *res) {this->res = res;}
 };
 
+struct Chunk { //terms lowered by one thread into their own groups
+  size_t begin, end;
+  std::deque<Event> events;
+  std::deque<Group*> groups;
+};
+
+class Elaborator: public Thread { //lowers independent terms in parallel
+  static std::vector<Chunk> chunks;
+  static const std::deque<Term*> *terms;
+  static size_t next; //the first chunk not taken yet
+  Counts counts;
+  void run();
+public:
+  static void lower(const std::deque<Term*> &);
+};
+
 #endif
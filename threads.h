@@ -31,6 +31,7 @@ class Thread { //called in each thread (arg=this):
   virtual void run() = 0;
 public: //create the thread identified by id and call static run2 for it:
   void start() {pthread_create(&id, NULL, run2, this);}
+  void join() {pthread_join(id, NULL);} //wait until run() returns
 };
 
 //threads container:
@@ -39,6 +40,10 @@ class Threads {
 public:
   void add(Thread *thread) {threads.push_back(thread);}
   void reserve(size_t size) {threads.reserve(size);} //allocate memory
+  void join() { //wait for finite threads:
+    std::vector<Thread*>::const_iterator it, end = threads.end();
+    for(it = threads.begin(); it != end; ++it) (*it)->join();
+  }
   void run() { //create threads:
     std::vector<Thread*>::const_iterator it, end = threads.end();
     for(it = threads.begin(); it != end; ++it) (*it)->start();
@@ -46,7 +46,9 @@ void Worker::run() {
     pthread_mutex_unlock(&mutex); //CS end
 
     //the main part of the thread (this line should take longest):
+    Counters::begin();
     ORD = group.solve(mults);
+    Counters::end(Counters::SOLVE);
 
     pthread_mutex_lock(&mutex); //CS begin
     if(ORD > MAXORD) MAXORD = ORD;